@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Compares two Google Benchmark JSON files and flags slowdowns.
+
+usage: bench_compare.py BASELINE CURRENT [--threshold 0.10] [--metric real_time]
+
+Benchmarks are matched by name; repeated runs of one benchmark are reduced to
+their median. Exits with status 1 if any benchmark in both files is slower
+than the baseline by more than the threshold (a fraction, 0.10 = 10%).
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+UNITS = {"ns": 1e-9, "us": 1e-6, "ms": 1e-3, "s": 1.0}
+
+
+def load(path, metric):
+    """Returns {name: seconds per iteration} for the runs in path."""
+    with open(path) as f:
+        runs = json.load(f)["benchmarks"]
+    times = {}
+    for run in runs:
+        if (run.get("run_type", "iteration") != "iteration"
+                or "error_occurred" in run):
+            continue
+        seconds = run[metric] * UNITS[run.get("time_unit", "ns")]
+        times.setdefault(run.get("run_name", run["name"]), []).append(seconds)
+    return {name: statistics.median(t) for name, t in times.items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10)
+    parser.add_argument("--metric", choices=("real_time", "cpu_time"),
+                        default="real_time")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline, args.metric)
+    current = load(args.current, args.metric)
+    width = max((len(name) for name in current), default=10)
+    slower = 0
+    for name, seconds in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}}  {'':>12}  {seconds:12.4g}  new")
+            continue
+        change = seconds / baseline[name] - 1.0
+        mark = ""
+        if change > args.threshold:
+            mark = "SLOWER"
+            slower += 1
+        elif change < -args.threshold:
+            mark = "faster"
+        print(f"{name:<{width}}  {baseline[name]:12.4g}  {seconds:12.4g}  "
+              f"{change:+7.1%}  {mark}")
+    for name in baseline.keys() - current.keys():
+        print(f"{name:<{width}}  {baseline[name]:12.4g}  {'':>12}  missing")
+    if slower:
+        print(f"{slower} benchmark(s) slower than the baseline by more than "
+              f"{args.threshold:.0%}")
+    return 1 if slower else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,230 @@
+#include "s21_allocator.h"
+
+#include <new>
+
+namespace {
+
+// Sits in the kS21BufferAlignment bytes in front of every buffer.
+struct Header {
+  void (*deallocate)(void* p, std::size_t bytes);
+  void* chunk;  // owning arena chunk, nullptr otherwise
+  std::size_t bytes;
+  int size_class;  // -1 when the block is too large for the pool
+};
+static_assert(sizeof(Header) <= kS21BufferAlignment - sizeof(std::atomic<int>),
+              "header overlaps the reference count");
+
+// Size classes are powers of two from 2^kMinClassLog2 to kS21PoolMaxBytes.
+constexpr int kMinClassLog2 = 7;
+constexpr int kClasses = 12;
+static_assert(std::size_t{1} << (kMinClassLog2 + kClasses - 1) ==
+                  kS21PoolMaxBytes,
+              "size classes must end at kS21PoolMaxBytes");
+
+void* DefaultAllocate(std::size_t bytes) {
+  return ::operator new(bytes, std::align_val_t(kS21BufferAlignment));
+}
+
+void DefaultDeallocate(void* p, std::size_t) {
+  ::operator delete(p, std::align_val_t(kS21BufferAlignment));
+}
+
+const S21Allocator kDefaultAllocator = {DefaultAllocate, DefaultDeallocate};
+
+std::atomic<const S21Allocator*> backing(&kDefaultAllocator);
+
+std::atomic<std::size_t> backing_count(0);
+std::atomic<std::size_t> pooled_count(0);
+std::atomic<std::size_t> arena_count(0);
+
+int SizeClass(std::size_t bytes) {
+  int size_class = -1;
+  if (bytes <= kS21PoolMaxBytes) {
+    size_class = 0;
+    while ((std::size_t{1} << (kMinClassLog2 + size_class)) < bytes) {
+      size_class++;
+    }
+  }
+  return size_class;
+}
+
+int PoolDepth(int size_class) {
+  std::size_t fit = kS21PoolClassBytes >> (kMinClassLog2 + size_class);
+  return fit < kS21PoolDepth ? static_cast<int>(fit) : kS21PoolDepth;
+}
+
+struct Pool {
+  ~Pool();
+  void* blocks[kClasses][kS21PoolDepth];
+  int sizes[kClasses] = {};
+  // The last arena chunk released on this thread, kept so that a loop
+  // opening one arena per iteration does not fault in fresh pages each time.
+  void* spare_chunk = nullptr;
+  std::size_t spare_bytes = 0;
+  void (*spare_deallocate)(void* p, std::size_t bytes) = nullptr;
+};
+
+// Outlives the pool, so buffers freed during thread teardown (by static
+// matrices, say) bypass it.
+thread_local bool pool_destroyed = false;
+
+Pool& LocalPool() {
+  thread_local Pool pool;
+  return pool;
+}
+
+Pool::~Pool() {
+  pool_destroyed = true;
+  for (int c = 0; c < kClasses; c++) {
+    for (int i = 0; i < sizes[c]; i++) {
+      Header* header = static_cast<Header*>(blocks[c][i]);
+      header->deallocate(header, header->bytes);
+    }
+  }
+  if (spare_chunk != nullptr) spare_deallocate(spare_chunk, spare_bytes);
+}
+
+thread_local S21MatrixArena* current_arena = nullptr;
+
+}  // namespace
+
+void S21SetAllocator(const S21Allocator* allocator) {
+  backing.store(allocator != nullptr ? allocator : &kDefaultAllocator,
+                std::memory_order_release);
+}
+
+double* S21AllocateBuffer(std::size_t count) {
+  std::size_t bytes = kS21BufferAlignment + count * sizeof(double);
+  bytes = (bytes + kS21BufferAlignment - 1) / kS21BufferAlignment *
+          kS21BufferAlignment;
+  Header* header = nullptr;
+  if (S21MatrixArena* arena = S21MatrixArena::Current()) {
+    header = static_cast<Header*>(arena->Allocate(bytes));
+    header->chunk = arena->current_;
+    header->deallocate = nullptr;
+    header->bytes = bytes;
+    header->size_class = -1;
+    arena_count.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    int size_class = SizeClass(bytes);
+    Pool* pool = pool_destroyed ? nullptr : &LocalPool();
+    if (size_class >= 0 && pool != nullptr && pool->sizes[size_class] > 0) {
+      header = static_cast<Header*>(
+          pool->blocks[size_class][--pool->sizes[size_class]]);
+      pooled_count.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      if (size_class >= 0) {
+        bytes = std::size_t{1} << (kMinClassLog2 + size_class);
+      }
+      const S21Allocator* allocator = backing.load(std::memory_order_acquire);
+      header = static_cast<Header*>(allocator->allocate(bytes));
+      header->deallocate = allocator->deallocate;
+      header->chunk = nullptr;
+      header->bytes = bytes;
+      header->size_class = size_class;
+      backing_count.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  double* buffer = reinterpret_cast<double*>(reinterpret_cast<char*>(header) +
+                                             kS21BufferAlignment);
+  new (S21BufferRefs(buffer)) std::atomic<int>(1);
+  return buffer;
+}
+
+void S21ShareBuffer(double* buffer) {
+  S21BufferRefs(buffer)->fetch_add(1, std::memory_order_relaxed);
+}
+
+void S21FreeBuffer(double* buffer) {
+  if (buffer == nullptr) return;
+  // A sole owner skips the atomic decrement; nobody else can share it now.
+  if (S21BufferShared(buffer) &&
+      S21BufferRefs(buffer)->fetch_sub(1, std::memory_order_acq_rel) > 1) {
+    return;
+  }
+  Header* header = reinterpret_cast<Header*>(reinterpret_cast<char*>(buffer) -
+                                             kS21BufferAlignment);
+  if (header->chunk != nullptr) {
+    S21MatrixArena::Release(static_cast<S21MatrixArena::Chunk*>(header->chunk));
+  } else {
+    int size_class = header->size_class;
+    Pool* pool = pool_destroyed ? nullptr : &LocalPool();
+    if (size_class >= 0 && pool != nullptr &&
+        pool->sizes[size_class] < PoolDepth(size_class)) {
+      pool->blocks[size_class][pool->sizes[size_class]++] = header;
+    } else {
+      header->deallocate(header, header->bytes);
+    }
+  }
+}
+
+S21AllocationStats S21GetAllocationStats() {
+  return {backing_count.load(std::memory_order_relaxed),
+          pooled_count.load(std::memory_order_relaxed),
+          arena_count.load(std::memory_order_relaxed)};
+}
+
+void S21ResetAllocationStats() {
+  backing_count.store(0, std::memory_order_relaxed);
+  pooled_count.store(0, std::memory_order_relaxed);
+  arena_count.store(0, std::memory_order_relaxed);
+}
+
+// --------------------------------------------------------------- arena --
+
+S21MatrixArena::S21MatrixArena(std::size_t chunk_bytes)
+    : chunk_bytes_(chunk_bytes), current_(nullptr), previous_(current_arena) {
+  current_arena = this;
+}
+
+S21MatrixArena::~S21MatrixArena() {
+  if (current_ != nullptr) Release(current_);
+  current_arena = previous_;
+}
+
+S21MatrixArena* S21MatrixArena::Current() { return current_arena; }
+
+void* S21MatrixArena::Allocate(std::size_t bytes) {
+  if (current_ == nullptr || current_->used + bytes > current_->capacity) {
+    if (current_ != nullptr) Release(current_);
+    std::size_t capacity = kS21BufferAlignment + bytes;
+    if (capacity < chunk_bytes_) capacity = chunk_bytes_;
+    Pool* pool = pool_destroyed ? nullptr : &LocalPool();
+    void* memory = nullptr;
+    void (*deallocate)(void* p, std::size_t bytes) = nullptr;
+    if (pool != nullptr && pool->spare_chunk != nullptr &&
+        pool->spare_bytes >= capacity) {
+      memory = pool->spare_chunk;
+      capacity = pool->spare_bytes;
+      deallocate = pool->spare_deallocate;
+      pool->spare_chunk = nullptr;
+    } else {
+      const S21Allocator* allocator = backing.load(std::memory_order_acquire);
+      memory = allocator->allocate(capacity);
+      deallocate = allocator->deallocate;
+      backing_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    current_ = new (memory) Chunk;
+    current_->refs.store(1, std::memory_order_relaxed);
+    current_->used = kS21BufferAlignment;
+    current_->capacity = capacity;
+    current_->deallocate = deallocate;
+  }
+  current_->refs.fetch_add(1, std::memory_order_relaxed);
+  void* block = reinterpret_cast<char*>(current_) + current_->used;
+  current_->used += bytes;
+  return block;
+}
+
+void S21MatrixArena::Release(Chunk* chunk) {
+  if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    Pool* pool = pool_destroyed ? nullptr : &LocalPool();
+    if (pool != nullptr && pool->spare_chunk == nullptr) {
+      pool->spare_chunk = chunk;
+      pool->spare_bytes = chunk->capacity;
+      pool->spare_deallocate = chunk->deallocate;
+    } else {
+      chunk->deallocate(chunk, chunk->capacity);
+    }
+  }
+}
@@ -0,0 +1,110 @@
+#ifndef SRC_S21_ALLOCATOR_H_
+#define SRC_S21_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Where S21Matrix buffers come from. Every buffer is 64-byte aligned and
+// preceded by a small header recording its origin, so it can be released
+// from any thread whichever way it was obtained:
+//  - inside an S21MatrixArena scope it is bump-allocated from the arena;
+//  - otherwise, up to kS21PoolMaxBytes, it is reused from a thread-local
+//    pool of power-of-two size classes;
+//  - anything else goes to the backing S21Allocator.
+
+// Backing allocator for pool misses, large buffers and arena chunks.
+// allocate must return memory aligned to kS21BufferAlignment.
+struct S21Allocator {
+  void* (*allocate)(std::size_t bytes);
+  void (*deallocate)(void* p, std::size_t bytes);
+};
+
+constexpr std::size_t kS21BufferAlignment = 64;
+// Largest block, header included, that the thread-local pool keeps.
+constexpr std::size_t kS21PoolMaxBytes = std::size_t{1} << 18;
+// Each thread keeps at most kS21PoolDepth free blocks and kS21PoolClassBytes
+// bytes per size class.
+constexpr int kS21PoolDepth = 16;
+constexpr std::size_t kS21PoolClassBytes = std::size_t{1} << 20;
+
+// Installs allocator (which must outlive every buffer it hands out) for
+// later allocations; nullptr restores aligned operator new.
+void S21SetAllocator(const S21Allocator* allocator);
+
+// A buffer of count doubles, uninitialized.
+double* S21AllocateBuffer(std::size_t count);
+void S21FreeBuffer(double* buffer);
+
+// Buffers are reference counted, so that copies of a matrix can share one
+// (see S21SetCopyOnWrite). A new buffer holds one reference, S21ShareBuffer
+// adds one and S21FreeBuffer drops one, releasing the buffer with the last.
+// The counts are atomic: owners on different threads may share and free
+// the same buffer concurrently.
+void S21ShareBuffer(double* buffer);
+
+// The count sits in the last bytes of the header in front of the buffer.
+inline std::atomic<int>* S21BufferRefs(const double* buffer) {
+  return reinterpret_cast<std::atomic<int>*>(
+      reinterpret_cast<std::uintptr_t>(buffer) - sizeof(std::atomic<int>));
+}
+
+// true while buffer has other owners besides the caller. Only an owner can
+// add owners, so once this is false it stays false until the caller shares
+// the buffer again. The acquire load orders the other owners' last reads
+// before the caller's writes.
+inline bool S21BufferShared(const double* buffer) {
+  return buffer != nullptr &&
+         S21BufferRefs(buffer)->load(std::memory_order_acquire) > 1;
+}
+
+// Process-wide counts of buffers handed out since the last reset.
+struct S21AllocationStats {
+  std::size_t backing;  // fresh blocks from the backing allocator
+  std::size_t pooled;   // blocks reused from a thread-local pool
+  std::size_t arena;    // blocks bump-allocated in an arena
+};
+S21AllocationStats S21GetAllocationStats();
+void S21ResetAllocationStats();
+
+// While alive, every buffer this thread allocates comes from the arena. A
+// buffer costs a pointer bump and freeing it is a counter decrement; the
+// chunks are released in one go when the arena is destroyed, the thread
+// keeping one of them for its next arena. Buffers that outlive the scope
+// (a returned matrix, say) stay valid and keep their chunk alive until they
+// are freed. Arenas nest; the innermost one is used.
+class S21MatrixArena {
+ public:
+  static constexpr std::size_t kDefaultChunkBytes = std::size_t{4} << 20;
+
+  explicit S21MatrixArena(std::size_t chunk_bytes = kDefaultChunkBytes);
+  S21MatrixArena(const S21MatrixArena&) = delete;
+  S21MatrixArena& operator=(const S21MatrixArena&) = delete;
+  ~S21MatrixArena();
+
+  // The arena of the calling thread, or nullptr outside any scope.
+  static S21MatrixArena* Current();
+
+ private:
+  struct Chunk {
+    // One reference per live block plus one held by the arena while the
+    // chunk is current.
+    std::atomic<std::size_t> refs;
+    std::size_t used;
+    std::size_t capacity;
+    void (*deallocate)(void* p, std::size_t bytes);
+  };
+
+  // bytes from the current chunk, starting a new one if it is full.
+  void* Allocate(std::size_t bytes);
+  static void Release(Chunk* chunk);
+
+  std::size_t chunk_bytes_;
+  Chunk* current_;
+  S21MatrixArena* previous_;
+
+  friend double* S21AllocateBuffer(std::size_t count);
+  friend void S21FreeBuffer(double* buffer);
+};
+
+#endif  // SRC_S21_ALLOCATOR_H_
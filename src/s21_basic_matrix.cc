@@ -0,0 +1,423 @@
+#include "s21_basic_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_gemm.h"
+#include "s21_lu.h"
+#include "s21_simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_BASIC_X86 1
+#endif
+
+namespace {
+
+// Reals the equality test checks between two looks at its flag.
+constexpr std::size_t kEqualChunk = 64;
+
+// Runs body, which must be always inlined, compiled for the instruction set
+// of S21GetKernels(), so its loops vectorize for the widest registers.
+template <class Body>
+void RunBase(const Body& body) {
+  body();
+}
+
+#ifdef S21_BASIC_X86
+
+template <class Body>
+__attribute__((target("avx2,fma"))) void RunAvx2(const Body& body) {
+  body();
+}
+
+template <class Body>
+__attribute__((target("avx512f"))) void RunAvx512(const Body& body) {
+  body();
+}
+
+#endif  // S21_BASIC_X86
+
+template <class Body>
+void Run(const Body& body) {
+#ifdef S21_BASIC_X86
+  S21Isa isa = S21GetKernels().isa;
+  if (isa == S21Isa::kAvx512) {
+    RunAvx512(body);
+  } else if (isa == S21Isa::kAvx2) {
+    RunAvx2(body);
+  } else {
+    RunBase(body);
+  }
+#else
+  RunBase(body);
+#endif
+}
+
+// The elements of a buffer as reals; std::complex is laid out as two.
+template <class T>
+typename S21ScalarTraits<T>::Real* Reals(T* data) {
+  return reinterpret_cast<typename S21ScalarTraits<T>::Real*>(data);
+}
+
+template <class T>
+const typename S21ScalarTraits<T>::Real* Reals(const T* data) {
+  return reinterpret_cast<const typename S21ScalarTraits<T>::Real*>(data);
+}
+
+// y[i] *= alpha for n elements, complex products spelled out so they
+// vectorize instead of calling the library's NaN-recovering multiply.
+template <class R>
+__attribute__((always_inline)) inline void Scale(int n, R alpha, R* y) {
+  for (int i = 0; i < n; i++) y[i] *= alpha;
+}
+
+template <class R>
+__attribute__((always_inline)) inline void Scale(int n,
+                                                 std::complex<R> alpha,
+                                                 std::complex<R>* y) {
+  R re = alpha.real();
+  R im = alpha.imag();
+  R* v = Reals(y);
+  for (int i = 0; i < n; i++) {
+    R x = v[2 * i];
+    R z = v[2 * i + 1];
+    v[2 * i] = x * re - z * im;
+    v[2 * i + 1] = x * im + z * re;
+  }
+}
+
+}  // namespace
+
+template <class T>
+BasicS21Matrix<T>::BasicS21Matrix() : BasicS21Matrix(1, 1) {}
+
+template <class T>
+BasicS21Matrix<T>::BasicS21Matrix(int rows, int cols)
+    : rows_(rows), cols_(cols), stride_(0), matrix_(nullptr) {
+  Alloc();
+}
+
+template <class T>
+BasicS21Matrix<T>::BasicS21Matrix(const BasicS21Matrix& other)
+    : BasicS21Matrix(other.rows_, other.cols_) {
+  std::copy(other.matrix_, other.matrix_ + Size(), matrix_);
+}
+
+template <class T>
+BasicS21Matrix<T>::BasicS21Matrix(BasicS21Matrix&& other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      matrix_(other.matrix_) {
+  other.rows_ = 0;
+  other.cols_ = 0;
+  other.stride_ = 0;
+  other.matrix_ = nullptr;
+}
+
+template <class T>
+BasicS21Matrix<T>::~BasicS21Matrix() {
+  if (matrix_ != nullptr) {
+    Dealloc();
+  }
+}
+
+template <class T>
+void BasicS21Matrix<T>::Alloc() {
+  if (rows_ < 1 || cols_ < 1) {
+    throw std::logic_error("Wrong size of the Matrix");
+  }
+  stride_ = (cols_ + kLanes - 1) / kLanes * kLanes;
+  // A row of kLanes elements is kAlignment bytes, so the buffer is a whole
+  // number of doubles.
+  matrix_ = reinterpret_cast<T*>(
+      S21AllocateBuffer(Size() * sizeof(T) / sizeof(double)));
+  std::uninitialized_fill_n(matrix_, Size(), T(0));
+}
+
+template <class T>
+void BasicS21Matrix<T>::Dealloc() {
+  S21FreeBuffer(reinterpret_cast<double*>(matrix_));
+  matrix_ = nullptr;
+}
+
+template <class T>
+void BasicS21Matrix<T>::SetRows(int rows) {
+  if (rows < 0) {
+    throw std::logic_error("The number of columns cannot be less than 0\n");
+  }
+  BasicS21Matrix result(rows, cols_);
+  std::copy(matrix_, RowData(std::min(rows, rows_)), result.matrix_);
+  *this = std::move(result);
+}
+
+template <class T>
+void BasicS21Matrix<T>::SetCols(int cols) {
+  if (cols < 0) {
+    throw std::logic_error("The number of columns cannot be less than 0\n");
+  }
+  BasicS21Matrix result(rows_, cols);
+  int kept = std::min(cols, cols_);
+  for (int i = 0; i < rows_; i++) {
+    std::copy(RowData(i), RowData(i) + kept, result.RowData(i));
+  }
+  *this = std::move(result);
+}
+
+template <class T>
+T BasicS21Matrix<T>::SetMatrix(T value) {
+  for (int i = 0; i < rows_; i++) {
+    std::fill(RowData(i), RowData(i) + cols_, value);
+  }
+  return value;
+}
+
+template <class T>
+void BasicS21Matrix<T>::CheckSameSize(const BasicS21Matrix& other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw std::logic_error("Matrix sizes are not identical\n");
+  }
+}
+
+template <class T>
+void BasicS21Matrix<T>::CheckSquare() const {
+  if (rows_ != cols_) {
+    throw std::logic_error("Matrix is not square\n");
+  }
+}
+
+template <class T>
+bool BasicS21Matrix<T>::EqMatrix(const BasicS21Matrix& other) const {
+  CheckSameSize(other);
+  // Row padding is zero in both matrices, so one flat pass suffices. Each
+  // chunk is reduced without branches and the pass stops after the first
+  // chunk with a miss.
+  const Real* x = Reals(matrix_);
+  const Real* y = Reals(other.matrix_);
+  std::size_t n = Size() * S21ScalarTraits<T>::kComponents;
+  Real eps = S21ScalarTraits<T>::kEpsilon;
+  bool equal = true;
+  Run([&]() __attribute__((always_inline)) {
+    for (std::size_t begin = 0; equal && begin < n; begin += kEqualChunk) {
+      std::size_t end = std::min(n, begin + kEqualChunk);
+      int miss = 0;
+      for (std::size_t i = begin; i < end; i++) {
+        miss |= !(std::fabs(x[i] - y[i]) <= eps);
+      }
+      equal = miss == 0;
+    }
+  });
+  return equal;
+}
+
+template <class T>
+void BasicS21Matrix<T>::SumMatrix(const BasicS21Matrix& other) {
+  CheckSameSize(other);
+  const Real* x = Reals(other.matrix_);
+  Real* y = Reals(matrix_);
+  std::size_t n = Size() * S21ScalarTraits<T>::kComponents;
+  Run([&]() __attribute__((always_inline)) {
+    for (std::size_t i = 0; i < n; i++) y[i] += x[i];
+  });
+}
+
+template <class T>
+void BasicS21Matrix<T>::SubMatrix(const BasicS21Matrix& other) {
+  CheckSameSize(other);
+  const Real* x = Reals(other.matrix_);
+  Real* y = Reals(matrix_);
+  std::size_t n = Size() * S21ScalarTraits<T>::kComponents;
+  Run([&]() __attribute__((always_inline)) {
+    for (std::size_t i = 0; i < n; i++) y[i] -= x[i];
+  });
+}
+
+template <class T>
+void BasicS21Matrix<T>::MulNumber(T num) {
+  // Row by row so that an infinite num never turns the padding into NaN.
+  Run([&]() __attribute__((always_inline)) {
+    for (int i = 0; i < rows_; i++) Scale(cols_, num, RowData(i));
+  });
+}
+
+template <class T>
+void BasicS21Matrix<T>::MulMatrix(const BasicS21Matrix& other) {
+  if (cols_ != other.rows_) {
+    throw std::out_of_range(
+        "the number of columns of the first matrix does not equal the number "
+        "of rows of the second matrix\n");
+  }
+  BasicS21Matrix tmp(rows_, other.cols_);
+  S21Gemm(rows_, other.cols_, cols_, T(1), matrix_, stride_, other.matrix_,
+          other.stride_, T(0), tmp.matrix_, tmp.stride_);
+  *this = std::move(tmp);
+}
+
+template <class T>
+BasicS21Matrix<T> BasicS21Matrix<T>::Transpose() const {
+  // Square tiles keep both the reads and the writes within a few lines.
+  constexpr int kTile = 16;
+  BasicS21Matrix result(cols_, rows_);
+  for (int i0 = 0; i0 < rows_; i0 += kTile) {
+    for (int j0 = 0; j0 < cols_; j0 += kTile) {
+      for (int i = i0; i < std::min(rows_, i0 + kTile); i++) {
+        const T* row = RowData(i);
+        for (int j = j0; j < std::min(cols_, j0 + kTile); j++) {
+          result.RowData(j)[i] = row[j];
+        }
+      }
+    }
+  }
+  return result;
+}
+
+template <class T>
+BasicS21Matrix<T> BasicS21Matrix<T>::Minor(int row, int col) const {
+  BasicS21Matrix minor(rows_ - 1, cols_ - 1);
+  for (int i = 0; i < minor.rows_; i++) {
+    const T* in = RowData(i < row ? i : i + 1);
+    T* out = minor.RowData(i);
+    std::copy(in, in + col, out);
+    std::copy(in + col + 1, in + cols_, out + col);
+  }
+  return minor;
+}
+
+template <class T>
+T BasicS21Matrix<T>::Determinant() const {
+  CheckSquare();
+  T det(0);
+  if (rows_ == 1) {
+    det = matrix_[0];
+  } else if (rows_ == 2) {
+    const T* top = RowData(0);
+    const T* bottom = RowData(1);
+    det = top[0] * bottom[1] - top[1] * bottom[0];
+  } else if (rows_ == 3) {
+    const T* r0 = RowData(0);
+    const T* r1 = RowData(1);
+    const T* r2 = RowData(2);
+    det = r0[0] * (r1[1] * r2[2] - r1[2] * r2[1]) -
+          r0[1] * (r1[0] * r2[2] - r1[2] * r2[0]) +
+          r0[2] * (r1[0] * r2[1] - r1[1] * r2[0]);
+  } else {
+    BasicS21Matrix lu(*this);
+    std::vector<int> piv(rows_);
+    det = T(S21LuFactor(rows_, lu.matrix_, lu.stride_, piv.data()));
+    for (int i = 0; det != T(0) && i < rows_; i++) {
+      det *= lu.RowData(i)[i];
+    }
+  }
+  return det;
+}
+
+template <class T>
+bool BasicS21Matrix<T>::Invert(BasicS21Matrix* inverse, T* det) const {
+  BasicS21Matrix lu(*this);
+  std::vector<int> piv(rows_);
+  int sign = S21LuFactor(rows_, lu.matrix_, lu.stride_, piv.data());
+  *det = T(sign);
+  for (int i = 0; sign != 0 && i < rows_; i++) {
+    *det *= lu.RowData(i)[i];
+    inverse->RowData(i)[i] = T(1);
+  }
+  if (sign != 0) {
+    S21LuSolve(rows_, lu.matrix_, lu.stride_, piv.data(), cols_,
+               inverse->matrix_, inverse->stride_);
+  }
+  return sign != 0;
+}
+
+template <class T>
+BasicS21Matrix<T> BasicS21Matrix<T>::InverseMatrix() const {
+  CheckSquare();
+  BasicS21Matrix inverse(rows_, cols_);
+  T det(0);
+  if (!Invert(&inverse, &det)) {
+    throw std::out_of_range("matrix determinant is 0");
+  }
+  return inverse;
+}
+
+template <class T>
+BasicS21Matrix<T> BasicS21Matrix<T>::CalcComplements() const {
+  CheckSquare();
+  BasicS21Matrix result(rows_, cols_);
+  BasicS21Matrix inverse(rows_, cols_);
+  T det(0);
+  if (cols_ == 1) {
+    result.matrix_[0] = T(1);
+  } else if (cols_ > 3 && Invert(&inverse, &det)) {
+    // adj(A) = det(A) * A^-1, so the complements are its transpose.
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) {
+        result.RowData(i)[j] = det * inverse.RowData(j)[i];
+      }
+    }
+  } else {
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) {
+        T minor = Minor(i, j).Determinant();
+        result.RowData(i)[j] = (i + j) % 2 == 0 ? minor : -minor;
+      }
+    }
+  }
+  return result;
+}
+
+template <class T>
+BasicS21Matrix<T>& BasicS21Matrix<T>::operator=(const BasicS21Matrix& other) {
+  if (this != &other) {
+    if (rows_ != other.rows_ || cols_ != other.cols_) {
+      *this = BasicS21Matrix(other);
+    } else {
+      std::copy(other.matrix_, other.matrix_ + Size(), matrix_);
+    }
+  }
+  return *this;
+}
+
+template <class T>
+BasicS21Matrix<T>& BasicS21Matrix<T>::operator=(
+    BasicS21Matrix&& other) noexcept {
+  if (this != &other) {
+    if (matrix_ != nullptr) {
+      Dealloc();
+    }
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    matrix_ = other.matrix_;
+    other.rows_ = 0;
+    other.cols_ = 0;
+    other.stride_ = 0;
+    other.matrix_ = nullptr;
+  }
+  return *this;
+}
+
+template <class T>
+T& BasicS21Matrix<T>::operator()(int i, int j) {
+  if ((i < 0 || i >= rows_) || (j < 0 || j >= cols_)) {
+    throw std::out_of_range("Incorrect input, index is out of range\n");
+  }
+  return RowData(i)[j];
+}
+
+template <class T>
+const T& BasicS21Matrix<T>::operator()(int i, int j) const {
+  if ((i < 0 || i >= rows_) || (j < 0 || j >= cols_)) {
+    throw std::out_of_range("Incorrect input, index is out of range\n");
+  }
+  return RowData(i)[j];
+}
+
+template class BasicS21Matrix<float>;
+template class BasicS21Matrix<long double>;
+template class BasicS21Matrix<std::complex<float>>;
+template class BasicS21Matrix<std::complex<double>>;
@@ -0,0 +1,138 @@
+#ifndef SRC_S21_BASIC_MATRIX_H_
+#define SRC_S21_BASIC_MATRIX_H_
+
+#include <complex>
+#include <cstddef>
+
+#include "s21_matrix_oop.h"
+#include "s21_scalar.h"
+
+// BasicS21Matrix<T> for T = float, long double, std::complex<float> and
+// std::complex<double>; S21Matrix is the double specialization in
+// s21_matrix_oop.h. The operations match S21Matrix: products run on
+// S21Gemm for T, Determinant, InverseMatrix and CalcComplements on
+// S21LuFactor for T, and the elementwise operations on kernels vectorized
+// for the instruction set S21GetKernels() selected. EqMatrix compares with
+// S21ScalarTraits<T>::kEpsilon. Expressions, views and file I/O stay
+// double-only.
+template <class T>
+class BasicS21Matrix {
+ public:
+  using value_type = T;
+  using Real = typename S21ScalarTraits<T>::Real;
+
+  BasicS21Matrix();
+  BasicS21Matrix(int rows, int cols);
+  BasicS21Matrix(const BasicS21Matrix& other);
+  BasicS21Matrix(BasicS21Matrix&& other) noexcept;
+  ~BasicS21Matrix();
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  void SetRows(int rows);
+  void SetCols(int cols);
+  T SetMatrix(T value);
+
+  bool EqMatrix(const BasicS21Matrix& other) const;
+  void SumMatrix(const BasicS21Matrix& other);
+  void SubMatrix(const BasicS21Matrix& other);
+  void MulNumber(T num);
+  void MulMatrix(const BasicS21Matrix& other);
+  BasicS21Matrix Transpose() const;
+  BasicS21Matrix CalcComplements() const;
+  T Determinant() const;
+  BasicS21Matrix InverseMatrix() const;
+
+  BasicS21Matrix& operator=(const BasicS21Matrix& other);
+  BasicS21Matrix& operator=(BasicS21Matrix&& other) noexcept;
+  bool operator==(const BasicS21Matrix& other) const {
+    return EqMatrix(other);
+  }
+  T& operator()(int i, int j);
+  const T& operator()(int i, int j) const;
+  BasicS21Matrix& operator+=(const BasicS21Matrix& other) {
+    SumMatrix(other);
+    return *this;
+  }
+  BasicS21Matrix& operator-=(const BasicS21Matrix& other) {
+    SubMatrix(other);
+    return *this;
+  }
+  BasicS21Matrix& operator*=(const BasicS21Matrix& other) {
+    MulMatrix(other);
+    return *this;
+  }
+  BasicS21Matrix& operator*=(T num) {
+    MulNumber(num);
+    return *this;
+  }
+
+  friend BasicS21Matrix operator+(BasicS21Matrix a, const BasicS21Matrix& b) {
+    return a += b;
+  }
+  friend BasicS21Matrix operator-(BasicS21Matrix a, const BasicS21Matrix& b) {
+    return a -= b;
+  }
+  friend BasicS21Matrix operator*(BasicS21Matrix a, const BasicS21Matrix& b) {
+    return a *= b;
+  }
+  friend BasicS21Matrix operator*(BasicS21Matrix a, T num) { return a *= num; }
+  friend BasicS21Matrix operator*(T num, BasicS21Matrix a) { return a *= num; }
+
+  // Same layout as S21Matrix: one row-major buffer aligned to kAlignment
+  // bytes, rows stride_ elements apart, stride_ a multiple of kLanes and the
+  // padding zeroed.
+  static constexpr std::size_t kAlignment = 64;
+  static constexpr int kLanes = kAlignment / sizeof(T);
+  const T* Data() const { return matrix_; }
+  T* Data() { return matrix_; }
+  int Stride() const { return stride_; }
+
+ private:
+  int rows_;
+  int cols_;
+  int stride_;
+  T* matrix_;
+
+  void Alloc();
+  void Dealloc();
+  std::size_t Size() const {
+    return static_cast<std::size_t>(rows_) * stride_;
+  }
+  T* RowData(int row) const {
+    return matrix_ + static_cast<std::ptrdiff_t>(row) * stride_;
+  }
+  void CheckSameSize(const BasicS21Matrix& other) const;
+  void CheckSquare() const;
+  // The matrix without row and column col.
+  BasicS21Matrix Minor(int row, int col) const;
+  // Writes A^-1 into inverse (an identity-sized matrix of zeros) and det(A)
+  // into det through an LU factorization; false if A is singular.
+  bool Invert(BasicS21Matrix* inverse, T* det) const;
+};
+
+extern template class BasicS21Matrix<float>;
+extern template class BasicS21Matrix<long double>;
+extern template class BasicS21Matrix<std::complex<float>>;
+extern template class BasicS21Matrix<std::complex<double>>;
+
+using S21MatrixF = BasicS21Matrix<float>;
+using S21MatrixL = BasicS21Matrix<long double>;
+using S21MatrixCF = BasicS21Matrix<std::complex<float>>;
+using S21MatrixCD = BasicS21Matrix<std::complex<double>>;
+
+// Element-by-element conversion, e.g. S21MatrixCast<float>(m) for an
+// S21Matrix m; From must convert to To with static_cast.
+template <class To, class From>
+BasicS21Matrix<To> S21MatrixCast(const BasicS21Matrix<From>& from) {
+  BasicS21Matrix<To> to(from.GetRows(), from.GetCols());
+  for (int i = 0; i < from.GetRows(); i++) {
+    const From* in = from.Data() + static_cast<std::ptrdiff_t>(i) *
+                                       from.Stride();
+    To* out = to.Data() + static_cast<std::ptrdiff_t>(i) * to.Stride();
+    for (int j = 0; j < from.GetCols(); j++) out[j] = static_cast<To>(in[j]);
+  }
+  return to;
+}
+
+#endif  // SRC_S21_BASIC_MATRIX_H_
@@ -0,0 +1,782 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_basic_matrix.h"
+#include "s21_factorization.h"
+#include "s21_fixed_matrix.h"
+#include "s21_matrix_batch.h"
+#include "s21_matrix_io.h"
+#include "s21_matrix_oop.h"
+#include "s21_out_of_core.h"
+#include "s21_sparse_matrix.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Runs a benchmark with threads pool threads, restoring the previous count
+// when it goes out of scope.
+class ScopedThreads {
+ public:
+  explicit ScopedThreads(int64_t threads) : saved_(S21GetNumThreads()) {
+    S21SetNumThreads(static_cast<int>(threads));
+  }
+  ~ScopedThreads() { S21SetNumThreads(saved_); }
+
+ private:
+  int saved_;
+};
+
+// Reports flops floating-point operations per iteration as GFLOPS.
+void SetFlops(benchmark::State& state, double flops) {
+  state.counters["GFLOPS"] =
+      benchmark::Counter(flops * state.iterations(),
+                         benchmark::Counter::kIsRate,
+                         benchmark::Counter::kIs1000);
+}
+
+// Reports bytes moved per iteration as bytes_per_second.
+void SetBytes(benchmark::State& state, double bytes) {
+  state.SetBytesProcessed(static_cast<int64_t>(bytes * state.iterations()));
+}
+
+// The row-pointer layout S21Matrix used before the contiguous buffer, kept
+// here as a baseline for the storage benchmarks.
+class RowPointerMatrix {
+ public:
+  RowPointerMatrix(int rows, int cols) : rows_(rows), cols_(cols) {
+    matrix_ = new double*[rows_];
+    for (int i = 0; i < rows_; i++) {
+      matrix_[i] = new double[cols_]{};
+    }
+  }
+  ~RowPointerMatrix() {
+    for (int i = 0; i < rows_; i++) {
+      delete[] matrix_[i];
+    }
+    delete[] matrix_;
+  }
+  void SumMatrix(const RowPointerMatrix& other) {
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) {
+        matrix_[i][j] += other.matrix_[i][j];
+      }
+    }
+  }
+
+ private:
+  int rows_;
+  int cols_;
+  double** matrix_;
+};
+
+void BM_ConstructRowPointer(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    RowPointerMatrix m(n, n);
+    benchmark::DoNotOptimize(&m);
+  }
+}
+
+void BM_Construct(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    S21Matrix m(n, n);
+    benchmark::DoNotOptimize(&m);
+  }
+}
+
+void BM_SumMatrixRowPointer(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  RowPointerMatrix a(n, n), b(n, n);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 3.0 * n * n * sizeof(double));
+}
+
+void BM_SumMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 3.0 * n * n * sizeof(double));
+}
+
+// The i-j-k triple loop MulMatrix used before the blocked GEMM.
+void BM_SumMatrixFloat(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21MatrixF a(n, n), b(n, n);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 3.0 * n * n * sizeof(float));
+}
+
+void BM_SubMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n);
+  for (auto _ : state) {
+    a.SubMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 3.0 * n * n * sizeof(double));
+}
+
+void BM_MulNumber(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    a.MulNumber(1.0);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 2.0 * n * n * sizeof(double));
+}
+
+// Equal operands, so every element is compared.
+void BM_EqMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  S21Matrix b(a);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.EqMatrix(b));
+  }
+  SetBytes(state, 2.0 * n * n * sizeof(double));
+}
+
+// The bandwidth the elementwise operations are held to: std::copy of one
+// n x n buffer into another, a read stream and a write stream.
+void BM_MemoryBandwidth(benchmark::State& state) {
+  std::size_t size = static_cast<std::size_t>(state.range(0)) * state.range(0);
+  std::vector<double> a(size, 1.0), b(size);
+  for (auto _ : state) {
+    std::copy(a.begin(), a.end(), b.begin());
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 2.0 * size * sizeof(double));
+}
+
+// The fused elementwise operations with state.range(1) threads. Bytes count
+// every stream: Axpy reads x and y and writes y, FusedMulAdd reads three
+// matrices and writes one.
+void BM_Axpy(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix x(n, n), y(n, n);
+  x.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    y.Axpy(1e-9, x);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 3.0 * n * n * sizeof(double));
+}
+
+void BM_Axpby(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix x(n, n), y(n, n);
+  x.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    y.Axpby(1e-9, x, 0.5);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 3.0 * n * n * sizeof(double));
+}
+
+void BM_FusedMulAdd(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix x(n, n), y(n, n), z(n, n);
+  x.SetMatrixIncremented(0.0);
+  y.SetMatrix(1e-9);
+  for (auto _ : state) {
+    z.FusedMulAdd(x, y);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 4.0 * n * n * sizeof(double));
+}
+
+void BM_HadamardProduct(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix x(n, n), y(n, n);
+  x.SetMatrix(1.0);
+  y.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    y.HadamardProduct(x);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 3.0 * n * n * sizeof(double));
+}
+
+void BM_HadamardDivide(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix x(n, n), y(n, n);
+  x.SetMatrix(1.0);
+  y.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    y.HadamardDivide(x);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 3.0 * n * n * sizeof(double));
+}
+
+void BM_Copy(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    S21Matrix b(a);
+    benchmark::DoNotOptimize(&b);
+  }
+  SetBytes(state, 2.0 * n * n * sizeof(double));
+}
+
+// A matrix passed by value through four stages that only read it, then
+// written once, with copy-on-write off (state.range(1) = 0) and on (1).
+// With sharing the four copies are free and only the write clones.
+double ReadStage(S21Matrix m) { return std::as_const(m)(0, 0); }
+
+void BM_CopyOnWrite(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  bool copy_on_write = S21GetCopyOnWrite();
+  S21SetCopyOnWrite(state.range(1) != 0);
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    double sum = 0.0;
+    for (int stage = 0; stage < 4; stage++) sum += ReadStage(a);
+    S21Matrix written(a);
+    written(0, 0) = sum;
+    benchmark::DoNotOptimize(&written);
+  }
+  S21SetCopyOnWrite(copy_on_write);
+}
+
+// Moves the buffer out and back; the cost should not depend on n.
+void BM_Move(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  for (auto _ : state) {
+    S21Matrix b(std::move(a));
+    a = std::move(b);
+    benchmark::DoNotOptimize(&a);
+  }
+}
+
+// Grows by one row and shrinks back, copying the matrix twice.
+void BM_SetRows(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    a.SetRows(n + 1);
+    a.SetRows(n);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 4.0 * n * n * sizeof(double));
+}
+
+void BM_SetCols(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    a.SetCols(n + 1);
+    a.SetCols(n);
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 4.0 * n * n * sizeof(double));
+}
+
+void BM_MulMatrixNaive(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n), c(n, n);
+  a.SetMatrixIncremented(0.0);
+  b.SetMatrixIncremented(1.0);
+  for (auto _ : state) {
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        double sum = 0.0;
+        for (int k = 0; k < n; k++) {
+          sum += a(i, k) * b(k, j);
+        }
+        c(i, j) = sum;
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  SetFlops(state, 2.0 * n * n * n);
+}
+
+void BM_MulMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix a(n, n), b(n, n);
+  a.SetMatrixIncremented(0.0);
+  b.SetMatrixIncremented(1.0);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrix(b);
+    benchmark::DoNotOptimize(&c);
+  }
+  SetFlops(state, 2.0 * n * n * n);
+}
+
+// The float and complex<float> GEMMs, against BM_MulMatrix for double.
+void BM_MulMatrixFloat(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21MatrixF a(n, n), b(n, n);
+  a.SetMatrix(0.5f);
+  b.SetMatrix(2.0f);
+  for (auto _ : state) {
+    S21MatrixF c(a);
+    c.MulMatrix(b);
+    benchmark::DoNotOptimize(&c);
+  }
+  SetFlops(state, 2.0 * n * n * n);
+}
+
+// c = op(a) * op(b) for the transpose combinations of state.range(1): NN,
+// NT, TN and TT. The transposes are read in place, so all four should run
+// at the speed of NN.
+void BM_MulTransposed(benchmark::State& state) {
+  static const char* const kLabels[] = {"NN", "NT", "TN", "TT"};
+  int n = static_cast<int>(state.range(0));
+  int variant = static_cast<int>(state.range(1));
+  S21Matrix a(n, n), b(n, n), c(n, n);
+  a.SetMatrixIncremented(0.0);
+  b.SetMatrixIncremented(1.0);
+  for (auto _ : state) {
+    if (variant == 0) {
+      c = a * b;
+    } else if (variant == 1) {
+      c = a * b.Transpose();
+    } else if (variant == 2) {
+      c = a.Transpose() * b;
+    } else {
+      c = a.Transpose() * b.Transpose();
+    }
+    benchmark::DoNotOptimize(c.Data());
+  }
+  state.SetLabel(kLabels[variant]);
+  SetFlops(state, 2.0 * n * n * n);
+}
+
+// A complex multiply-add is 8 real flops.
+void BM_MulMatrixComplexFloat(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21MatrixCF a(n, n), b(n, n);
+  a.SetMatrix({0.5f, 1.0f});
+  b.SetMatrix({2.0f, -1.0f});
+  for (auto _ : state) {
+    S21MatrixCF c(a);
+    c.MulMatrix(b);
+    benchmark::DoNotOptimize(&c);
+  }
+  SetFlops(state, 8.0 * n * n * n);
+}
+
+void BM_MulMatrixStrassen(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n);
+  a.SetMatrixIncremented(0.0);
+  b.SetMatrixIncremented(1.0);
+  for (auto _ : state) {
+    S21Matrix c(a);
+    c.MulMatrix(b, S21MulAlgorithm::kStrassen);
+    benchmark::DoNotOptimize(&c);
+  }
+  SetFlops(state, 2.0 * n * n * n);
+}
+
+// The element-by-element loop Transpose evaluated through before the blocked
+// kernel: the reads walk down columns of a.
+void BM_TransposeNaive(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n);
+  a.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        b(i, j) = a(j, i);
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 2.0 * n * n * sizeof(double));
+}
+
+void BM_Transpose(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n), b(n, n);
+  a.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    b = a.Transpose();
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 2.0 * n * n * sizeof(double));
+}
+
+void BM_TransposeInPlace(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  for (auto _ : state) {
+    a = a.Transpose();
+    benchmark::ClobberMemory();
+  }
+  SetBytes(state, 2.0 * n * n * sizeof(double));
+}
+
+void BM_Determinant(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(1.0);
+  for (int i = 0; i < n; i++) a(i, i) += n * n;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a.Determinant());
+  }
+  SetFlops(state, 2.0 / 3.0 * n * n * n);
+}
+
+void BM_InverseMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(1.0);
+  for (int i = 0; i < n; i++) a(i, i) += n * n;
+  for (auto _ : state) {
+    S21Matrix inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(&inverse);
+  }
+  SetFlops(state, 2.0 * n * n * n);
+}
+
+void BM_CalcComplements(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(1.0);
+  for (int i = 0; i < n; i++) a(i, i) += n * n;
+  for (auto _ : state) {
+    S21Matrix complements = a.CalcComplements();
+    benchmark::DoNotOptimize(&complements);
+  }
+  SetFlops(state, 2.0 * n * n * n);
+}
+
+// Factor and solve one right-hand side: double LU against float LU with
+// iterative refinement to the same accuracy.
+void BM_SolveLU(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix a(n, n), b(n, 1);
+  a.SetMatrixIncremented(1.0);
+  for (int i = 0; i < n; i++) a(i, i) += n * n;
+  b.SetMatrix(1.0);
+  for (auto _ : state) {
+    S21Matrix x = S21LU(a).Solve(b);
+    benchmark::DoNotOptimize(&x);
+  }
+  SetFlops(state, 2.0 / 3.0 * n * n * n);
+}
+
+void BM_SolveMixed(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  ScopedThreads threads(state.range(1));
+  S21Matrix a(n, n), b(n, 1);
+  a.SetMatrixIncremented(1.0);
+  for (int i = 0; i < n; i++) a(i, i) += n * n;
+  b.SetMatrix(1.0);
+  S21RefinementInfo info = {};
+  for (auto _ : state) {
+    S21Matrix x = S21MixedLU(a).Solve(b, &info);
+    benchmark::DoNotOptimize(&x);
+  }
+  SetFlops(state, 2.0 / 3.0 * n * n * n);
+  state.counters["iterations"] = info.iterations;
+  state.counters["residual"] = info.residual;
+}
+
+// Singular matrices take the minor-by-minor path, which allocates two
+// temporaries per complement. range(1) runs each iteration in an arena.
+void BM_CalcComplementsSingular(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  bool arena = state.range(1) != 0;
+  S21Matrix a(n, n);
+  a.SetMatrix(1.0);
+  S21ResetAllocationStats();
+  for (auto _ : state) {
+    std::unique_ptr<S21MatrixArena> scope;
+    if (arena) scope.reset(new S21MatrixArena);
+    S21Matrix complements = a.CalcComplements();
+    benchmark::DoNotOptimize(&complements);
+  }
+  S21AllocationStats stats = S21GetAllocationStats();
+  state.counters["backing"] = benchmark::Counter(
+      stats.backing, benchmark::Counter::kAvgIterations);
+  state.counters["pooled"] = benchmark::Counter(
+      stats.pooled, benchmark::Counter::kAvgIterations);
+  state.counters["arena"] = benchmark::Counter(
+      stats.arena, benchmark::Counter::kAvgIterations);
+}
+
+// 4 x 4 transform chains: the dynamic matrix against S21FixedMatrix.
+void BM_Small4x4Dynamic(benchmark::State& state) {
+  S21Matrix a(4, 4);
+  a.SetMatrixIncremented(1.0);
+  for (int i = 0; i < 4; i++) a(i, i) += 40.0;
+  for (auto _ : state) {
+    S21Matrix product = a * a;
+    S21Matrix inverse = product.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.Determinant());
+  }
+}
+
+void BM_Small4x4Fixed(benchmark::State& state) {
+  S21FixedMatrix<4, 4> a;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) a(i, j) = 4 * i + j + 1 + 40.0 * (i == j);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(&a);
+    S21FixedMatrix<4, 4> product = a * a;
+    S21FixedMatrix<4, 4> inverse = product.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.Determinant());
+  }
+}
+
+// state.range(1) n x n matrices, each multiplied by itself and inverted: one
+// S21Matrix at a time against one S21MatrixBatch.
+void BM_SmallLoop(benchmark::State& state) {
+  int n = state.range(0);
+  std::vector<S21Matrix> members(state.range(1), S21Matrix(n, n));
+  for (std::size_t k = 0; k < members.size(); k++) {
+    members[k].SetMatrixIncremented(k);
+    for (int i = 0; i < n; i++) members[k](i, i) += 10.0 * n * n;
+  }
+  for (auto _ : state) {
+    for (S21Matrix& member : members) {
+      S21Matrix product = member * member;
+      benchmark::DoNotOptimize(product.InverseMatrix());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+void BM_SmallBatch(benchmark::State& state) {
+  int n = state.range(0);
+  S21MatrixBatch batch(state.range(1), n, n);
+  for (int k = 0; k < batch.GetCount(); k++) {
+    S21Matrix member(n, n);
+    member.SetMatrixIncremented(k);
+    for (int i = 0; i < n; i++) member(i, i) += 10.0 * n * n;
+    batch.Set(k, member);
+  }
+  for (auto _ : state) {
+    S21MatrixBatch product = batch;
+    product.MulMatrix(batch);
+    benchmark::DoNotOptimize(product.InverseMatrix());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+// An n x n matrix with about density_permille / 1000 of its entries set.
+S21Matrix RandomSparse(int n, int density_permille) {
+  std::mt19937 engine(42);
+  std::uniform_int_distribution<int> index(0, n - 1);
+  S21Matrix a(n, n);
+  long long count = static_cast<long long>(n) * n * density_permille / 1000;
+  for (long long k = 0; k < count; k++) a(index(engine), index(engine)) = 1.0;
+  return a;
+}
+
+// Products with a 4000 x 4000 matrix of state.range(0) per mille density
+// against a vector (one column) or state.range(1) columns: CSR against the
+// dense GEMM.
+void BM_DenseMulSparse(benchmark::State& state) {
+  S21Matrix a = RandomSparse(4000, static_cast<int>(state.range(0)));
+  S21Matrix b(4000, static_cast<int>(state.range(1)));
+  b.SetMatrix(1.0);
+  for (auto _ : state) {
+    S21Matrix c = a * b;
+    benchmark::DoNotOptimize(&c);
+  }
+}
+
+void BM_SparseMul(benchmark::State& state) {
+  S21SparseMatrix a(RandomSparse(4000, static_cast<int>(state.range(0))));
+  S21Matrix b(4000, static_cast<int>(state.range(1)));
+  b.SetMatrix(1.0);
+  std::vector<double> x(4000, 1.0);
+  for (auto _ : state) {
+    if (state.range(1) == 1) {
+      benchmark::DoNotOptimize(a * x);
+    } else {
+      benchmark::DoNotOptimize(a * b);
+    }
+  }
+  state.counters["nnz"] = a.NonZeros();
+}
+
+// Opening an n x n matrix file: reading it into an S21Matrix against mapping
+// it and reading one element.
+void BM_LoadMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  a.Save("s21_bench_matrix.bin");
+  for (auto _ : state) {
+    S21Matrix loaded = S21Matrix::Load("s21_bench_matrix.bin");
+    benchmark::DoNotOptimize(&loaded);
+  }
+  std::remove("s21_bench_matrix.bin");
+  SetBytes(state, 1.0 * n * n * sizeof(double));
+}
+
+void BM_MapMatrix(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  a.Save("s21_bench_matrix.bin");
+  for (auto _ : state) {
+    S21MappedMatrix mapped("s21_bench_matrix.bin");
+    benchmark::DoNotOptimize(mapped.View()(n - 1, n - 1));
+  }
+  std::remove("s21_bench_matrix.bin");
+}
+
+// n x n product of two matrix files with state.range(1) MiB of tiles; compare
+// with BM_MulMatrix/n/1.
+void BM_MultiplyFiles(benchmark::State& state) {
+  int n = static_cast<int>(state.range(0));
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(0.0);
+  a.Save("s21_bench_a.bin");
+  a.Save("s21_bench_b.bin");
+  for (auto _ : state) {
+    state.counters["tile"] =
+        S21MultiplyFiles("s21_bench_a.bin", "s21_bench_b.bin",
+                         "s21_bench_c.bin",
+                         static_cast<std::size_t>(state.range(1)) << 20);
+  }
+  std::remove("s21_bench_a.bin");
+  std::remove("s21_bench_b.bin");
+  std::remove("s21_bench_c.bin");
+  SetFlops(state, 2.0 * n * n * n);
+}
+
+}  // namespace
+
+BENCHMARK(BM_MulMatrixNaive)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MulMatrix)
+    ->ArgsProduct({{256, 1024, 2048, 4096}, {1, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MulMatrixFloat)
+    ->ArgsProduct({{256, 1024, 2048}, {1, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MulMatrixComplexFloat)
+    ->ArgsProduct({{256, 1024}, {1, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MulTransposed)
+    ->ArgsProduct({{256, 1024, 2048}, {0, 1, 2, 3}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MulMatrixStrassen)
+    ->Arg(1024)
+    ->Arg(2048)
+    ->Arg(4096)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TransposeNaive)->Arg(512)->Arg(2048)->Arg(4096);
+BENCHMARK(BM_Transpose)->Arg(512)->Arg(2048)->Arg(4096);
+BENCHMARK(BM_TransposeInPlace)->Arg(512)->Arg(2048)->Arg(4096);
+BENCHMARK(BM_Determinant)
+    ->ArgsProduct({{4, 12, 100, 500, 2000}, {1, 4}})
+    ->UseRealTime();
+BENCHMARK(BM_InverseMatrix)
+    ->ArgsProduct({{4, 100, 500, 2000}, {1, 4}})
+    ->UseRealTime();
+BENCHMARK(BM_CalcComplements)
+    ->ArgsProduct({{4, 100, 500}, {1, 4}})
+    ->UseRealTime();
+BENCHMARK(BM_SolveLU)
+    ->ArgsProduct({{256, 1024, 2048}, {1, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SolveMixed)
+    ->ArgsProduct({{256, 1024, 2048}, {1, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CalcComplementsSingular)->ArgsProduct({{6, 24}, {0, 1}});
+BENCHMARK(BM_Small4x4Dynamic);
+BENCHMARK(BM_Small4x4Fixed);
+BENCHMARK(BM_SmallLoop)->ArgsProduct({{3, 4}, {1024, 65536}});
+BENCHMARK(BM_SmallBatch)->ArgsProduct({{3, 4}, {1024, 65536}});
+BENCHMARK(BM_DenseMulSparse)
+    ->ArgsProduct({{1, 10, 100}, {1, 32}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SparseMul)
+    ->ArgsProduct({{1, 10, 100}, {1, 32}})
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LoadMatrix)->Arg(1000)->Arg(4000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MapMatrix)->Arg(1000)->Arg(4000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_MultiplyFiles)
+    ->ArgsProduct({{2048}, {4, 16, 64}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConstructRowPointer)->Arg(64)->Arg(512)->Arg(2000);
+BENCHMARK(BM_Construct)->Arg(64)->Arg(512)->Arg(2000);
+BENCHMARK(BM_SumMatrixRowPointer)->Arg(64)->Arg(512)->Arg(2000);
+BENCHMARK(BM_SumMatrix)->Arg(64)->Arg(512)->Arg(2000);
+BENCHMARK(BM_SumMatrixFloat)->Arg(64)->Arg(512)->Arg(2000);
+BENCHMARK(BM_SubMatrix)->Arg(64)->Arg(512)->Arg(2000);
+BENCHMARK(BM_MulNumber)->Arg(64)->Arg(512)->Arg(2000);
+BENCHMARK(BM_EqMatrix)->Arg(64)->Arg(512)->Arg(2000)->Arg(4000);
+BENCHMARK(BM_Copy)->Arg(64)->Arg(512)->Arg(2000);
+BENCHMARK(BM_MemoryBandwidth)->Arg(512)->Arg(2000)->Arg(4000);
+BENCHMARK(BM_Axpy)
+    ->ArgsProduct({{512, 2000, 4000}, {1, 4}})
+    ->UseRealTime();
+BENCHMARK(BM_Axpby)
+    ->ArgsProduct({{512, 2000, 4000}, {1, 4}})
+    ->UseRealTime();
+BENCHMARK(BM_FusedMulAdd)
+    ->ArgsProduct({{512, 2000, 4000}, {1, 4}})
+    ->UseRealTime();
+BENCHMARK(BM_HadamardProduct)
+    ->ArgsProduct({{512, 2000, 4000}, {1, 4}})
+    ->UseRealTime();
+BENCHMARK(BM_HadamardDivide)
+    ->ArgsProduct({{512, 2000, 4000}, {1, 4}})
+    ->UseRealTime();
+BENCHMARK(BM_CopyOnWrite)->ArgsProduct({{64, 512, 2000}, {0, 1}});
+BENCHMARK(BM_Move)->Arg(64)->Arg(2000);
+BENCHMARK(BM_SetRows)->Arg(64)->Arg(512)->Arg(2000);
+BENCHMARK(BM_SetCols)->Arg(64)->Arg(512)->Arg(2000);
+
+BENCHMARK_MAIN();
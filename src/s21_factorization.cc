@@ -0,0 +1,434 @@
+#include "s21_factorization.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+
+#include "s21_gemm.h"
+#include "s21_lu.h"
+#include "s21_scalar.h"
+
+namespace {
+
+void CheckSquare(const S21ConstMatrixView& a) {
+  if (a.GetRows() != a.GetCols()) {
+    throw std::logic_error("Matrix is not square\n");
+  }
+}
+
+void CheckRows(int rows, int expected) {
+  if (rows != expected) {
+    throw std::logic_error(
+        "the number of rows of the right-hand side does not match the "
+        "factored matrix\n");
+  }
+}
+
+S21Matrix Identity(int n) {
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) {
+    identity(i, i) = 1.0;
+  }
+  return identity;
+}
+
+S21Matrix ColumnFromVector(const std::vector<double>& b) {
+  S21Matrix column(static_cast<int>(b.size()), 1);
+  for (int i = 0; i < column.GetRows(); i++) {
+    column(i, 0) = b[i];
+  }
+  return column;
+}
+
+std::vector<double> VectorFromColumn(S21Matrix column) {
+  std::vector<double> x(column.GetRows());
+  for (int i = 0; i < column.GetRows(); i++) {
+    x[i] = column(i, 0);
+  }
+  return x;
+}
+
+// max |m(i, j)| of every column j.
+std::vector<double> ColumnNorms(const S21ConstMatrixView& m) {
+  std::vector<double> norms(m.GetCols(), 0.0);
+  for (int i = 0; i < m.GetRows(); i++) {
+    const double* row = m.RowData(i);
+    for (int j = 0; j < m.GetCols(); j++) {
+      norms[j] = std::max(norms[j], std::fabs(row[j]));
+    }
+  }
+  return norms;
+}
+
+}  // namespace
+
+// ------------------------------------------------------------------- LU --
+
+S21LU::S21LU(const S21ConstMatrixView& a)
+    : lu_(a), piv_(a.GetRows()), sign_(0) {
+  CheckSquare(a);
+  sign_ = S21LuFactor(lu_.rows_, lu_.matrix_, lu_.stride_, piv_.data());
+}
+
+bool S21LU::IsSingular() const { return sign_ == 0; }
+
+S21Matrix S21LU::Solve(const S21ConstMatrixView& b) const {
+  CheckRows(b.GetRows(), lu_.rows_);
+  if (IsSingular()) {
+    throw std::out_of_range("matrix determinant is 0");
+  }
+  S21Matrix x(b);
+  S21LuSolve(lu_.rows_, lu_.matrix_, lu_.stride_, piv_.data(), x.cols_,
+             x.matrix_, x.stride_);
+  return x;
+}
+
+std::vector<double> S21LU::Solve(const std::vector<double>& b) const {
+  return VectorFromColumn(Solve(ColumnFromVector(b)));
+}
+
+S21Matrix S21LU::SolveTransposed(const S21ConstMatrixView& b) const {
+  CheckRows(b.GetRows(), lu_.rows_);
+  if (IsSingular()) {
+    throw std::out_of_range("matrix determinant is 0");
+  }
+  S21Matrix x(b);
+  S21LuSolveTransposed(lu_.rows_, lu_.matrix_, lu_.stride_, piv_.data(),
+                       x.cols_, x.matrix_, x.stride_);
+  return x;
+}
+
+std::vector<double> S21LU::SolveTransposed(
+    const std::vector<double>& b) const {
+  return VectorFromColumn(SolveTransposed(ColumnFromVector(b)));
+}
+
+double S21LU::Determinant() const {
+  double det = sign_;
+  for (int i = 0; det != 0.0 && i < lu_.rows_; i++) {
+    det *= lu_.RowData(i)[i];
+  }
+  return det;
+}
+
+S21Matrix S21LU::Inverse() const { return Solve(Identity(lu_.rows_)); }
+
+// ------------------------------------------------------------- Cholesky --
+
+S21Cholesky::S21Cholesky(const S21ConstMatrixView& a)
+    : l_(a.GetRows(), a.GetCols()) {
+  CheckSquare(a);
+  for (int j = 0; j < l_.rows_; j++) {
+    double* lj = l_.RowData(j);
+    const double* aj = a.RowData(j);
+    for (int i = 0; i <= j; i++) {
+      const double* li = l_.RowData(i);
+      double sum = aj[i];
+      for (int p = 0; p < i; p++) {
+        sum -= lj[p] * li[p];
+      }
+      if (i < j) {
+        lj[i] = sum / li[i];
+      } else if (sum > 0.0) {
+        lj[j] = std::sqrt(sum);
+      } else {
+        throw std::logic_error("Matrix is not positive definite\n");
+      }
+    }
+  }
+}
+
+S21Matrix S21Cholesky::Solve(const S21ConstMatrixView& b) const {
+  CheckRows(b.GetRows(), l_.rows_);
+  S21Matrix x(b);
+  int n = l_.rows_;
+  int k = x.cols_;
+  // L * y = b, then L^T * x = y.
+  for (int i = 0; i < n; i++) {
+    const double* li = l_.RowData(i);
+    double* row = x.RowData(i);
+    for (int p = 0; p < i; p++) {
+      const double* solved = x.RowData(p);
+      for (int c = 0; c < k; c++) {
+        row[c] -= li[p] * solved[c];
+      }
+    }
+    for (int c = 0; c < k; c++) {
+      row[c] /= li[i];
+    }
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    const double* li = l_.RowData(i);
+    double* row = x.RowData(i);
+    for (int c = 0; c < k; c++) {
+      row[c] /= li[i];
+    }
+    for (int p = 0; p < i; p++) {
+      double* pending = x.RowData(p);
+      for (int c = 0; c < k; c++) {
+        pending[c] -= li[p] * row[c];
+      }
+    }
+  }
+  return x;
+}
+
+std::vector<double> S21Cholesky::Solve(const std::vector<double>& b) const {
+  return VectorFromColumn(Solve(ColumnFromVector(b)));
+}
+
+double S21Cholesky::Determinant() const {
+  double det = 1.0;
+  for (int i = 0; i < l_.rows_; i++) {
+    double diagonal = l_.RowData(i)[i];
+    det *= diagonal * diagonal;
+  }
+  return det;
+}
+
+S21Matrix S21Cholesky::Inverse() const { return Solve(Identity(l_.rows_)); }
+
+// ------------------------------------------------------------------- QR --
+
+S21QR::S21QR(const S21ConstMatrixView& a) : qr_(a), tau_(a.GetCols()) {
+  if (a.GetRows() < a.GetCols()) {
+    throw std::logic_error(
+        "QR needs at least as many rows as columns in the matrix\n");
+  }
+  int m = qr_.rows_;
+  int n = qr_.cols_;
+  std::vector<double> w(n);
+  for (int j = 0; j < n; j++) {
+    double alpha = qr_.RowData(j)[j];
+    double tail = 0.0;
+    for (int i = j + 1; i < m; i++) {
+      double v = qr_.RowData(i)[j];
+      tail += v * v;
+    }
+    tau_[j] = 0.0;
+    if (tail == 0.0) continue;
+    // H = I - tau * v * v^T maps column j onto beta * e_j, v_j = 1.
+    double beta = -std::copysign(std::sqrt(alpha * alpha + tail), alpha);
+    tau_[j] = (beta - alpha) / beta;
+    double scale = 1.0 / (alpha - beta);
+    for (int i = j + 1; i < m; i++) {
+      qr_.RowData(i)[j] *= scale;
+    }
+    qr_.RowData(j)[j] = beta;
+    // Apply H to the trailing columns: w = v^T * A, A -= tau * v * w.
+    const double* top = qr_.RowData(j);
+    for (int c = j + 1; c < n; c++) {
+      w[c] = top[c];
+    }
+    for (int i = j + 1; i < m; i++) {
+      const double* row = qr_.RowData(i);
+      for (int c = j + 1; c < n; c++) {
+        w[c] += row[j] * row[c];
+      }
+    }
+    for (int i = j; i < m; i++) {
+      double* row = qr_.RowData(i);
+      double v = i == j ? 1.0 : row[j];
+      for (int c = j + 1; c < n; c++) {
+        row[c] -= tau_[j] * v * w[c];
+      }
+    }
+  }
+}
+
+bool S21QR::IsRankDeficient() const {
+  // Column i of R has the norm of column i of A, the scale R_ii is
+  // measured against.
+  bool res = false;
+  for (int i = 0; !res && i < qr_.cols_; i++) {
+    double norm = 0.0;
+    for (int p = 0; p <= i; p++) {
+      norm += qr_.RowData(p)[i] * qr_.RowData(p)[i];
+    }
+    res = std::fabs(qr_.RowData(i)[i]) <=
+          S21PivotTolerance(qr_.rows_, std::sqrt(norm));
+  }
+  return res;
+}
+
+S21Matrix S21QR::Solve(const S21ConstMatrixView& b) const {
+  CheckRows(b.GetRows(), qr_.rows_);
+  if (IsRankDeficient()) {
+    throw std::out_of_range("matrix is rank deficient\n");
+  }
+  int m = qr_.rows_;
+  int n = qr_.cols_;
+  S21Matrix y(b);
+  int k = y.cols_;
+  std::vector<double> w(k);
+  // y = Q^T * b, one reflection at a time.
+  for (int j = 0; j < n; j++) {
+    if (tau_[j] == 0.0) continue;
+    const double* top = y.RowData(j);
+    for (int c = 0; c < k; c++) {
+      w[c] = top[c];
+    }
+    for (int i = j + 1; i < m; i++) {
+      double v = qr_.RowData(i)[j];
+      const double* row = y.RowData(i);
+      for (int c = 0; c < k; c++) {
+        w[c] += v * row[c];
+      }
+    }
+    for (int i = j; i < m; i++) {
+      double v = i == j ? 1.0 : qr_.RowData(i)[j];
+      double* row = y.RowData(i);
+      for (int c = 0; c < k; c++) {
+        row[c] -= tau_[j] * v * w[c];
+      }
+    }
+  }
+  // R * x = (Q^T * b)[0:n].
+  S21Matrix x(n, k);
+  for (int i = n - 1; i >= 0; i--) {
+    const double* ri = qr_.RowData(i);
+    double* row = x.RowData(i);
+    const double* rhs = y.RowData(i);
+    for (int c = 0; c < k; c++) {
+      row[c] = rhs[c];
+    }
+    for (int p = i + 1; p < n; p++) {
+      const double* solved = x.RowData(p);
+      for (int c = 0; c < k; c++) {
+        row[c] -= ri[p] * solved[c];
+      }
+    }
+    for (int c = 0; c < k; c++) {
+      row[c] /= ri[i];
+    }
+  }
+  return x;
+}
+
+std::vector<double> S21QR::Solve(const std::vector<double>& b) const {
+  return VectorFromColumn(Solve(ColumnFromVector(b)));
+}
+
+double S21QR::Determinant() const {
+  CheckSquare(qr_);
+  if (IsRankDeficient()) return 0.0;
+  double det = 1.0;
+  for (int i = 0; i < qr_.rows_; i++) {
+    det *= qr_.RowData(i)[i];
+    // Every non-trivial Householder reflection has determinant -1.
+    if (tau_[i] != 0.0) det = -det;
+  }
+  return det;
+}
+
+S21Matrix S21QR::Inverse() const {
+  CheckSquare(qr_);
+  return Solve(Identity(qr_.rows_));
+}
+
+// ------------------------------------------------------------- mixed LU --
+
+S21MixedLU::S21MixedLU(const S21ConstMatrixView& a, double tolerance,
+                       int max_iterations)
+    : a_(a),
+      lu_(a.GetRows(), a.GetCols()),
+      piv_(a.GetRows()),
+      a_norm_(0.0),
+      tolerance_(tolerance),
+      max_iterations_(max_iterations) {
+  CheckSquare(a);
+  int n = a_.GetRows();
+  bool in_range = true;
+  for (int i = 0; i < n; i++) {
+    const double* row = a.RowData(i);
+    float* out = lu_.Data() + static_cast<std::ptrdiff_t>(i) * lu_.Stride();
+    double sum = 0.0;
+    for (int j = 0; j < n; j++) {
+      sum += std::fabs(row[j]);
+      in_range = in_range && std::fabs(row[j]) <= FLT_MAX;
+      out[j] = static_cast<float>(row[j]);
+    }
+    a_norm_ = std::max(a_norm_, sum);
+  }
+  if (tolerance_ <= 0.0) tolerance_ = std::sqrt(n) * DBL_EPSILON;
+  int sign = 0;
+  if (in_range) sign = S21LuFactor(n, lu_.Data(), lu_.Stride(), piv_.data());
+  // Growth can overflow float even when A is in range.
+  for (int i = 0; sign != 0 && i < n; i++) {
+    if (!std::isfinite(lu_(i, i))) sign = 0;
+  }
+  if (sign == 0) fallback_.emplace(a_);
+}
+
+double S21MixedLU::BackwardError(const S21ConstMatrixView& b,
+                                 const S21Matrix& x, S21Matrix* r) const {
+  int n = a_.GetRows();
+  int k = b.GetCols();
+  for (int i = 0; i < n; i++) {
+    std::copy(b.RowData(i), b.RowData(i) + k,
+              r->Data() + static_cast<std::ptrdiff_t>(i) * r->Stride());
+  }
+  S21Gemm(n, k, n, -1.0, a_.Data(), a_.Stride(), x.Data(), x.Stride(), 1.0,
+          r->Data(), r->Stride());
+  std::vector<double> r_norms = ColumnNorms(*r);
+  std::vector<double> x_norms = ColumnNorms(x);
+  std::vector<double> b_norms = ColumnNorms(b);
+  double error = 0.0;
+  for (int j = 0; j < k; j++) {
+    double scale = a_norm_ * x_norms[j] + b_norms[j];
+    double column = scale > 0.0 ? r_norms[j] / scale : r_norms[j];
+    // Written so that a NaN residual wins.
+    error = column <= error ? error : column;
+  }
+  return error;
+}
+
+S21Matrix S21MixedLU::Solve(const S21ConstMatrixView& b,
+                            S21RefinementInfo* info) const {
+  CheckRows(b.GetRows(), a_.GetRows());
+  int n = a_.GetRows();
+  int k = b.GetCols();
+  S21RefinementInfo result = {0, 0.0, fallback_.has_value()};
+  S21Matrix x(n, k);
+  S21Matrix r(b);
+  if (!result.fallback) {
+    // x starts at 0, so the first correction is the float solution of b.
+    S21MatrixF correction(n, k);
+    bool converged = false;
+    for (int step = 0; !converged && step <= max_iterations_; step++) {
+      for (int i = 0; i < n; i++) {
+        const double* in = r.Data() + static_cast<std::ptrdiff_t>(i) *
+                                          r.Stride();
+        float* out = correction.Data() +
+                     static_cast<std::ptrdiff_t>(i) * correction.Stride();
+        for (int j = 0; j < k; j++) out[j] = static_cast<float>(in[j]);
+      }
+      S21LuSolve(n, lu_.Data(), lu_.Stride(), piv_.data(), k,
+                 correction.Data(), correction.Stride());
+      for (int i = 0; i < n; i++) {
+        const float* in = correction.Data() +
+                          static_cast<std::ptrdiff_t>(i) * correction.Stride();
+        double* out =
+            x.MutableData() + static_cast<std::ptrdiff_t>(i) * x.Stride();
+        for (int j = 0; j < k; j++) out[j] += in[j];
+      }
+      result.residual = BackwardError(b, x, &r);
+      result.iterations = step;
+      converged = result.residual <= tolerance_;
+    }
+    result.fallback = !converged;
+  }
+  if (result.fallback) {
+    if (!fallback_) fallback_.emplace(a_);
+    x = fallback_->Solve(b);
+    result.residual = BackwardError(b, x, &r);
+  }
+  if (info != nullptr) *info = result;
+  return x;
+}
+
+std::vector<double> S21MixedLU::Solve(const std::vector<double>& b,
+                                      S21RefinementInfo* info) const {
+  return VectorFromColumn(Solve(ColumnFromVector(b), info));
+}
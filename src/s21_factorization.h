@@ -0,0 +1,117 @@
+#ifndef SRC_S21_FACTORIZATION_H_
+#define SRC_S21_FACTORIZATION_H_
+
+#include <optional>
+#include <vector>
+
+#include "s21_basic_matrix.h"
+#include "s21_matrix_oop.h"
+
+// Factorizations that are computed once and then reused for any number of
+// right-hand sides. Solve() takes an n x k matrix of right-hand sides (k = 1
+// for a single system) or a plain vector and returns the solutions in the
+// same shape. Matrices and views of them are accepted alike.
+
+// P * A = L * U with partial pivoting for square A.
+class S21LU {
+ public:
+  explicit S21LU(const S21ConstMatrixView& a);
+
+  bool IsSingular() const;
+  S21Matrix Solve(const S21ConstMatrixView& b) const;
+  std::vector<double> Solve(const std::vector<double>& b) const;
+  // Solves A^T * X = b with the factors of A.
+  S21Matrix SolveTransposed(const S21ConstMatrixView& b) const;
+  std::vector<double> SolveTransposed(const std::vector<double>& b) const;
+  double Determinant() const;
+  S21Matrix Inverse() const;
+
+ private:
+  S21Matrix lu_;
+  std::vector<int> piv_;
+  int sign_;
+};
+
+// A = L * L^T for symmetric positive definite A. Only the lower triangle of
+// A is read; the constructor throws std::logic_error if A is not positive
+// definite.
+class S21Cholesky {
+ public:
+  explicit S21Cholesky(const S21ConstMatrixView& a);
+
+  S21Matrix Solve(const S21ConstMatrixView& b) const;
+  std::vector<double> Solve(const std::vector<double>& b) const;
+  double Determinant() const;
+  S21Matrix Inverse() const;
+
+ private:
+  S21Matrix l_;
+};
+
+// A = Q * R with Householder reflections for an m x n matrix A, m >= n.
+// Solve() returns the least-squares solution (n x k) of A * X = b (m x k).
+// Determinant() and Inverse() require a square A.
+class S21QR {
+ public:
+  explicit S21QR(const S21ConstMatrixView& a);
+
+  bool IsRankDeficient() const;
+  S21Matrix Solve(const S21ConstMatrixView& b) const;
+  std::vector<double> Solve(const std::vector<double>& b) const;
+  double Determinant() const;
+  S21Matrix Inverse() const;
+
+ private:
+  // R on and above the diagonal, the Householder vectors (with an implicit
+  // leading 1) below it.
+  S21Matrix qr_;
+  std::vector<double> tau_;
+};
+
+// How a S21MixedLU solve went.
+struct S21RefinementInfo {
+  // Refinement steps taken after the first float solve.
+  int iterations;
+  // Largest normwise backward error over the columns of the solution,
+  // ||b - A x|| / (||A|| ||x|| + ||b||) in the infinity norm.
+  double residual;
+  // true when the solution came from a double-precision factorization.
+  bool fallback;
+};
+
+// Mixed-precision LU for square A: factored in float with the float GEMM,
+// which does about twice the flops per second, then each solve refines its
+// float solution with residuals computed in double until the backward error
+// is at most tolerance; 0 selects sqrt(n) * DBL_EPSILON, the criterion of
+// LAPACK's dsgesv. A solve that has not converged after max_iterations
+// steps is redone with a double factorization (S21LU), which is kept for the
+// later solves; if A is singular or out of range in float, the constructor
+// factors it in double right away. Solves throw std::out_of_range if A is
+// singular in double as well.
+class S21MixedLU {
+ public:
+  explicit S21MixedLU(const S21ConstMatrixView& a, double tolerance = 0.0,
+                      int max_iterations = 30);
+
+  bool UsesFallback() const { return fallback_.has_value(); }
+  S21Matrix Solve(const S21ConstMatrixView& b,
+                  S21RefinementInfo* info = nullptr) const;
+  std::vector<double> Solve(const std::vector<double>& b,
+                            S21RefinementInfo* info = nullptr) const;
+
+ private:
+  // ||b - A x|| / (||A|| ||x|| + ||b||) of the worst column; *r = b - A x.
+  double BackwardError(const S21ConstMatrixView& b, const S21Matrix& x,
+                       S21Matrix* r) const;
+
+  S21Matrix a_;
+  S21MatrixF lu_;
+  std::vector<int> piv_;
+  double a_norm_;
+  double tolerance_;
+  int max_iterations_;
+  // Built by the first solve that does not converge.
+  mutable std::optional<S21LU> fallback_;
+};
+
+#endif  // SRC_S21_FACTORIZATION_H_
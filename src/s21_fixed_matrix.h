@@ -0,0 +1,327 @@
+#ifndef SRC_S21_FIXED_MATRIX_H_
+#define SRC_S21_FIXED_MATRIX_H_
+
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_matrix_oop.h"
+#include "s21_scalar.h"
+
+// An R x C matrix whose shape is part of its type. The elements live inside
+// the object (no allocation), every loop has compile-time bounds so the
+// compiler unrolls it, and shape mismatches (adding a 2 x 3 to a 3 x 2,
+// inverting a non-square matrix) fail to compile instead of throwing.
+// Index checks and singular inverses still throw like S21Matrix.
+//
+// Conversions: S21FixedMatrix<R, C>(matrix) copies from an R x C S21Matrix
+// or view, View() exposes the elements as a view without copying and
+// ToMatrix() copies them into a new S21Matrix.
+template <int R, int C>
+class S21FixedMatrix {
+  static_assert(R > 0 && C > 0, "a matrix needs at least one row and column");
+
+ public:
+  static constexpr int kRows = R;
+  static constexpr int kCols = C;
+
+  constexpr S21FixedMatrix() : matrix_{} {}
+  // The R * C elements in row-major order.
+  template <class... T,
+            class = std::enable_if_t<
+                sizeof...(T) == R * C &&
+                std::conjunction_v<std::is_arithmetic<T>...>>>
+  constexpr explicit S21FixedMatrix(T... values)
+      : matrix_{static_cast<double>(values)...} {}
+  explicit S21FixedMatrix(const S21ConstMatrixView& other) : matrix_{} {
+    if (other.GetRows() != R || other.GetCols() != C) {
+      throw std::logic_error("Matrix sizes are not identical\n");
+    }
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) At(i, j) = other.At(i, j);
+    }
+  }
+
+  static constexpr S21FixedMatrix Identity() {
+    static_assert(R == C, "Matrix is not square");
+    S21FixedMatrix identity;
+    for (int i = 0; i < R; i++) identity.At(i, i) = 1.0;
+    return identity;
+  }
+
+  static constexpr int GetRows() { return R; }
+  static constexpr int GetCols() { return C; }
+
+  // Unchecked access.
+  constexpr double& At(int i, int j) { return matrix_[i * C + j]; }
+  constexpr double At(int i, int j) const { return matrix_[i * C + j]; }
+  constexpr double& operator()(int i, int j) {
+    CheckIndex(i, j);
+    return At(i, j);
+  }
+  constexpr double operator()(int i, int j) const {
+    CheckIndex(i, j);
+    return At(i, j);
+  }
+
+  S21ConstMatrixView View() const { return {matrix_, R, C, C}; }
+  S21MatrixView View() { return {matrix_, R, C, C}; }
+  S21Matrix ToMatrix() const { return S21Matrix(View()); }
+
+  constexpr bool EqMatrix(const S21FixedMatrix& other) const {
+    constexpr double kEps = 0.0000001;
+    bool res = true;
+    for (int k = 0; k < R * C; k++) {
+      double accuracy = matrix_[k] - other.matrix_[k];
+      res = res && accuracy <= kEps && accuracy >= -kEps;
+    }
+    return res;
+  }
+  constexpr bool operator==(const S21FixedMatrix& other) const {
+    return EqMatrix(other);
+  }
+
+  constexpr S21FixedMatrix& operator+=(const S21FixedMatrix& other) {
+    for (int k = 0; k < R * C; k++) matrix_[k] += other.matrix_[k];
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator-=(const S21FixedMatrix& other) {
+    for (int k = 0; k < R * C; k++) matrix_[k] -= other.matrix_[k];
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(double num) {
+    for (int k = 0; k < R * C; k++) matrix_[k] *= num;
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const S21FixedMatrix<C, C>& other) {
+    *this = *this * other;
+    return *this;
+  }
+
+  constexpr S21FixedMatrix<C, R> Transpose() const {
+    static_assert(R != 1 || C != 1, "Wrong matrix size");
+    S21FixedMatrix<C, R> result;
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) result.At(j, i) = At(i, j);
+    }
+    return result;
+  }
+
+  // The matrix without row and col.
+  constexpr S21FixedMatrix<R - 1, C - 1> Minor(int row, int col) const {
+    static_assert(R > 1 && C > 1, "Wrong matrix size");
+    S21FixedMatrix<R - 1, C - 1> minor;
+    for (int i = 0; i < R - 1; i++) {
+      for (int j = 0; j < C - 1; j++) {
+        minor.At(i, j) = At(i + (i >= row), j + (j >= col));
+      }
+    }
+    return minor;
+  }
+
+  constexpr double Determinant() const;
+  constexpr S21FixedMatrix CalcComplements() const;
+  S21FixedMatrix InverseMatrix() const;
+
+ private:
+  constexpr void CheckIndex(int i, int j) const {
+    if (i < 0 || i >= R || j < 0 || j >= C) {
+      throw std::out_of_range("Incorrect input, index is out of range\n");
+    }
+  }
+
+  double matrix_[R * C];
+};
+
+// Row of the largest |a(i, col)| for i >= col.
+template <int R, int C>
+constexpr int S21PivotRow(const S21FixedMatrix<R, C>& a, int col) {
+  int pivot = col;
+  double best = 0.0;
+  for (int i = col; i < R; i++) {
+    double value = a.At(i, col) < 0.0 ? -a.At(i, col) : a.At(i, col);
+    if (value > best) {
+      best = value;
+      pivot = i;
+    }
+  }
+  return pivot;
+}
+
+// The largest |a(i, j)| of each row into rows and of each column into cols;
+// the scales S21LuFactor measures pivots against.
+template <int R, int C>
+constexpr void S21PivotScales(const S21FixedMatrix<R, C>& a, double (&rows)[R],
+                              double (&cols)[C]) {
+  for (int i = 0; i < R; i++) {
+    for (int j = 0; j < C; j++) {
+      double value = a.At(i, j) < 0.0 ? -a.At(i, j) : a.At(i, j);
+      if (value > rows[i]) rows[i] = value;
+      if (value > cols[j]) cols[j] = value;
+    }
+  }
+}
+
+// Whether the pivot a(k, k) is rounding noise at the scale of its row and
+// column, as S21LuFactor decides.
+template <int R, int C>
+constexpr bool S21IsNoisePivot(const S21FixedMatrix<R, C>& a, int k,
+                               double row_scale, double col_scale) {
+  double value = a.At(k, k) < 0.0 ? -a.At(k, k) : a.At(k, k);
+  double scale = row_scale < col_scale ? row_scale : col_scale;
+  return value <= S21PivotTolerance(R, scale);
+}
+
+template <int R, int C>
+constexpr S21FixedMatrix<R, C> operator+(S21FixedMatrix<R, C> lhs,
+                                         const S21FixedMatrix<R, C>& rhs) {
+  return lhs += rhs;
+}
+
+template <int R, int C>
+constexpr S21FixedMatrix<R, C> operator-(S21FixedMatrix<R, C> lhs,
+                                         const S21FixedMatrix<R, C>& rhs) {
+  return lhs -= rhs;
+}
+
+template <int R, int C>
+constexpr S21FixedMatrix<R, C> operator*(S21FixedMatrix<R, C> lhs,
+                                         double num) {
+  return lhs *= num;
+}
+
+template <int R, int C>
+constexpr S21FixedMatrix<R, C> operator*(double num,
+                                         S21FixedMatrix<R, C> rhs) {
+  return rhs *= num;
+}
+
+template <int R, int K, int C>
+constexpr S21FixedMatrix<R, C> operator*(const S21FixedMatrix<R, K>& lhs,
+                                         const S21FixedMatrix<K, C>& rhs) {
+  S21FixedMatrix<R, C> result;
+  for (int i = 0; i < R; i++) {
+    for (int p = 0; p < K; p++) {
+      double a = lhs.At(i, p);
+      for (int j = 0; j < C; j++) result.At(i, j) += a * rhs.At(p, j);
+    }
+  }
+  return result;
+}
+
+template <int R, int C>
+constexpr double S21FixedMatrix<R, C>::Determinant() const {
+  static_assert(R == C, "Matrix is not square");
+  double det = 0.0;
+  if constexpr (R == 1) {
+    det = At(0, 0);
+  } else if constexpr (R == 2) {
+    det = At(0, 0) * At(1, 1) - At(0, 1) * At(1, 0);
+  } else if constexpr (R <= 4) {
+    // Expansion along the first row; the minors unroll down to 2 x 2.
+    for (int j = 0; j < C; j++) {
+      double term = At(0, j) * Minor(0, j).Determinant();
+      det += j % 2 == 0 ? term : -term;
+    }
+  } else {
+    // Gaussian elimination with partial pivoting on a copy.
+    S21FixedMatrix lu = *this;
+    double rows[R] = {};
+    double cols[C] = {};
+    S21PivotScales(lu, rows, cols);
+    det = 1.0;
+    for (int k = 0; det != 0.0 && k < R; k++) {
+      int pivot = S21PivotRow(lu, k);
+      if (pivot != k) {
+        for (int j = 0; j < C; j++) {
+          double top = lu.At(k, j);
+          lu.At(k, j) = lu.At(pivot, j);
+          lu.At(pivot, j) = top;
+        }
+        double top = rows[k];
+        rows[k] = rows[pivot];
+        rows[pivot] = top;
+        det = -det;
+      }
+      det *= S21IsNoisePivot(lu, k, rows[k], cols[k]) ? 0.0 : lu.At(k, k);
+      for (int i = k + 1; det != 0.0 && i < R; i++) {
+        double factor = lu.At(i, k) / lu.At(k, k);
+        for (int j = k + 1; j < C; j++) lu.At(i, j) -= factor * lu.At(k, j);
+      }
+    }
+  }
+  return det;
+}
+
+template <int R, int C>
+constexpr S21FixedMatrix<R, C> S21FixedMatrix<R, C>::CalcComplements() const {
+  static_assert(R == C, "Matrix is not square");
+  S21FixedMatrix result;
+  if constexpr (R == 1) {
+    result.At(0, 0) = 1.0;
+  } else {
+    for (int i = 0; i < R; i++) {
+      for (int j = 0; j < C; j++) {
+        double minor = Minor(i, j).Determinant();
+        result.At(i, j) = (i + j) % 2 == 0 ? minor : -minor;
+      }
+    }
+  }
+  return result;
+}
+
+template <int R, int C>
+S21FixedMatrix<R, C> S21FixedMatrix<R, C>::InverseMatrix() const {
+  static_assert(R == C, "Matrix is not square");
+  S21FixedMatrix inverse;
+  if constexpr (R == 1) {
+    if (At(0, 0) == 0.0) {
+      throw std::out_of_range("matrix determinant is 0");
+    }
+    inverse.At(0, 0) = 1.0 / At(0, 0);
+  } else if constexpr (R <= 4) {
+    // A^-1 = adj(A) / det(A), with the determinant expanded along the first
+    // row of the complements.
+    S21FixedMatrix complements = CalcComplements();
+    double det = 0.0;
+    for (int j = 0; j < C; j++) det += At(0, j) * complements.At(0, j);
+    if (det == 0.0) {
+      throw std::out_of_range("matrix determinant is 0");
+    }
+    inverse = complements.Transpose() * (1.0 / det);
+  } else {
+    // Gauss-Jordan with partial pivoting.
+    S21FixedMatrix a = *this;
+    inverse = Identity();
+    double rows[R] = {};
+    double cols[C] = {};
+    S21PivotScales(a, rows, cols);
+    for (int k = 0; k < R; k++) {
+      int pivot = S21PivotRow(a, k);
+      for (int j = 0; j < C; j++) {
+        std::swap(a.At(k, j), a.At(pivot, j));
+        std::swap(inverse.At(k, j), inverse.At(pivot, j));
+      }
+      std::swap(rows[k], rows[pivot]);
+      if (S21IsNoisePivot(a, k, rows[k], cols[k])) {
+        throw std::out_of_range("matrix determinant is 0");
+      }
+      double scale = 1.0 / a.At(k, k);
+      for (int j = 0; j < C; j++) {
+        a.At(k, j) *= scale;
+        inverse.At(k, j) *= scale;
+      }
+      for (int i = 0; i < R; i++) {
+        double factor = a.At(i, k);
+        if (i == k || factor == 0.0) continue;
+        for (int j = 0; j < C; j++) {
+          a.At(i, j) -= factor * a.At(k, j);
+          inverse.At(i, j) -= factor * inverse.At(k, j);
+        }
+      }
+    }
+  }
+  return inverse;
+}
+
+#endif  // SRC_S21_FIXED_MATRIX_H_
@@ -0,0 +1,509 @@
+#include "s21_gemm.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "s21_scalar.h"
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Cache blocking around the microkernel's mr x nr register tile: a kKc x nr
+// sliver of B stays in L1, a kMc x kKc block of A in L2 and a kKc x kNc panel
+// of B in L3. kMc and kNc are multiples of every kernel's mr and nr.
+constexpr int kKc = 256;
+constexpr int kMc = 120;
+constexpr int kNc = 4096;
+
+// Products below kParallelFlops stay on the calling thread; larger ones are
+// cut into output tiles of at least kMinTile x kMinTile.
+constexpr double kParallelFlops = 1 << 22;
+constexpr int kMinTile = 64;
+
+// Products with at most kDotColumns columns, such as the matrix-vector
+// products of triangular solves, skip the packing and run as dot products.
+constexpr int kDotColumns = 4;
+
+// Element (i, p) of an operand is data[i * row_step + p * col_step]: a
+// row-major matrix has steps (ld, 1) and its transpose, read in place,
+// (1, ld). The offsets are taken in std::ptrdiff_t so they do not overflow
+// int on large matrices.
+template <class T>
+struct Operand {
+  const T* data;
+  std::ptrdiff_t row_step;
+  std::ptrdiff_t col_step;
+
+  const T& operator()(int i, int p) const {
+    return data[static_cast<std::ptrdiff_t>(i) * row_step +
+                static_cast<std::ptrdiff_t>(p) * col_step];
+  }
+  // The operand that starts at element (i, p).
+  Operand At(int i, int p) const {
+    return {&(*this)(i, p), row_step, col_step};
+  }
+};
+
+template <class T>
+Operand<T> MakeOperand(S21GemmOp op, const T* data, int ld) {
+  if (op == S21GemmOp::kTrans) return {data, 1, ld};
+  return {data, ld, 1};
+}
+
+// Copies an mc x kc block of A into mr-row slivers stored column by column,
+// zero-padding the last sliver so the microkernel never branches on edges.
+// A transposed operand is packed the same way, so the kernels never see it.
+void PackA(int mc, int kc, int mr, Operand<double> a, double* packed) {
+  for (int i = 0; i < mc; i += mr) {
+    int rows = std::min(mr, mc - i);
+    for (int p = 0; p < kc; p++) {
+      for (int r = 0; r < mr; r++) {
+        *packed++ = r < rows ? a(i + r, p) : 0.0;
+      }
+    }
+  }
+}
+
+// Copies a kc x nc panel of B into nr-column slivers stored row by row.
+void PackB(int kc, int nc, int nr, Operand<double> b, double* packed) {
+  for (int j = 0; j < nc; j += nr) {
+    int cols = std::min(nr, nc - j);
+    for (int p = 0; p < kc; p++) {
+      for (int c = 0; c < nr; c++) {
+        *packed++ = c < cols ? b(p, j + c) : 0.0;
+      }
+    }
+  }
+}
+
+template <class T>
+void ScaleC(int m, int n, T beta, T* c, int ldc) {
+  for (int i = 0; i < m; i++) {
+    T* row = c + static_cast<std::ptrdiff_t>(i) * ldc;
+    if (beta == T(0)) {
+      std::fill(row, row + n, T(0));
+    } else if (beta != T(1)) {
+      for (int j = 0; j < n; j++) {
+        row[j] *= beta;
+      }
+    }
+  }
+}
+
+// C += alpha * packed A * packed B for one mc x nc block.
+void MacroKernel(const S21Kernels& kernels, int mc, int nc, int kc,
+                 double alpha, const double* packed_a, const double* packed_b,
+                 double* c, int ldc) {
+  int mr = kernels.gemm_mr;
+  int nr = kernels.gemm_nr;
+  double ab[kS21MaxMr * kS21MaxNr];
+  for (int j = 0; j < nc; j += nr) {
+    int cols = std::min(nr, nc - j);
+    for (int i = 0; i < mc; i += mr) {
+      int rows = std::min(mr, mc - i);
+      kernels.gemm(kc, packed_a + i * kc, packed_b + j * kc, ab);
+      for (int r = 0; r < rows; r++) {
+        double* out = c + static_cast<std::ptrdiff_t>(i + r) * ldc + j;
+        for (int s = 0; s < cols; s++) {
+          out[s] += alpha * ab[r * nr + s];
+        }
+      }
+    }
+  }
+}
+
+int RoundUp(int value, int multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+void GemmSerial(int m, int n, int k, double alpha, Operand<double> a,
+                Operand<double> b, double* c, int ldc) {
+  const S21Kernels& kernels = S21GetKernels();
+  int mr = kernels.gemm_mr;
+  int nr = kernels.gemm_nr;
+  std::vector<double> packed_a(RoundUp(std::min(m, kMc), mr) *
+                               std::min(k, kKc));
+  std::vector<double> packed_b(RoundUp(std::min(n, kNc), nr) *
+                               std::min(k, kKc));
+  for (int jc = 0; jc < n; jc += kNc) {
+    int nc = std::min(kNc, n - jc);
+    for (int pc = 0; pc < k; pc += kKc) {
+      int kc = std::min(kKc, k - pc);
+      PackB(kc, nc, nr, b.At(pc, jc), packed_b.data());
+      for (int ic = 0; ic < m; ic += kMc) {
+        int mc = std::min(kMc, m - ic);
+        PackA(mc, kc, mr, a.At(ic, pc), packed_a.data());
+        MacroKernel(kernels, mc, nc, kc, alpha, packed_a.data(),
+                    packed_b.data(),
+                    c + static_cast<std::ptrdiff_t>(ic) * ldc + jc, ldc);
+      }
+    }
+  }
+}
+
+// C += alpha * A * B as dot products of the rows of A with the columns of
+// B, each summed in kSums independent lanes. When A is read transposed its
+// rows are strided, so the columns of C are built from its columns instead.
+template <class T>
+void GemmDots(int m, int n, int k, T alpha, Operand<T> a, Operand<T> b, T* c,
+              int ldc) {
+  constexpr int kSums = 8;
+  std::vector<T> column(k);
+  std::vector<T> sums_by_row(a.col_step == 1 ? 0 : m);
+  for (int j = 0; j < n; j++) {
+    for (int p = 0; p < k; p++) column[p] = b(p, j);
+    if (a.col_step != 1) {
+      std::fill(sums_by_row.begin(), sums_by_row.end(), T(0));
+      for (int p = 0; p < k; p++) {
+        const T* a_column = &a(0, p);
+        for (int i = 0; i < m; i++) {
+          sums_by_row[i] += a_column[i * a.row_step] * column[p];
+        }
+      }
+      for (int i = 0; i < m; i++) {
+        c[static_cast<std::ptrdiff_t>(i) * ldc + j] += alpha * sums_by_row[i];
+      }
+      continue;
+    }
+    for (int i = 0; i < m; i++) {
+      const T* row = &a(i, 0);
+      T sums[kSums] = {};
+      int p = 0;
+      for (; p + kSums <= k; p += kSums) {
+        for (int s = 0; s < kSums; s++) sums[s] += row[p + s] * column[p + s];
+      }
+      T dot = T(0);
+      for (int s = 0; s < kSums; s++) dot += sums[s];
+      for (; p < k; p++) dot += row[p] * column[p];
+      c[static_cast<std::ptrdiff_t>(i) * ldc + j] += alpha * dot;
+    }
+  }
+}
+
+// C += alpha * A * B in parallel tiles of C, each computed by
+// serial(m, n, k, alpha, a, b, c, ldc).
+template <class T, class Serial>
+void Tiled(int m, int n, int k, T alpha, Operand<T> a, Operand<T> b, T* c,
+           int ldc, const Serial& serial) {
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  int threads = pool.GetThreads();
+  if (threads == 1 || 2.0 * m * n * k < kParallelFlops) {
+    serial(m, n, k, alpha, a, b, c, ldc);
+    return;
+  }
+  // Split the longer side of C first until there are a few tiles per thread.
+  int row_tiles = 1;
+  int col_tiles = 1;
+  while (row_tiles * col_tiles < 4 * threads) {
+    bool split_rows = m / row_tiles >= n / col_tiles;
+    if (split_rows && m / (row_tiles + 1) >= kMinTile) {
+      row_tiles++;
+    } else if (n / (col_tiles + 1) >= kMinTile) {
+      col_tiles++;
+    } else if (m / (row_tiles + 1) >= kMinTile) {
+      row_tiles++;
+    } else {
+      break;
+    }
+  }
+  int tile_m = (m + row_tiles - 1) / row_tiles;
+  int tile_n = (n + col_tiles - 1) / col_tiles;
+  pool.ParallelFor(row_tiles * col_tiles, [=, &serial](int tile) {
+    int i = tile / col_tiles * tile_m;
+    int j = tile % col_tiles * tile_n;
+    if (i < m && j < n) {
+      serial(std::min(tile_m, m - i), std::min(tile_n, n - j), k, alpha,
+             a.At(i, 0), b.At(0, j),
+             c + static_cast<std::ptrdiff_t>(i) * ldc + j, ldc);
+    }
+  });
+}
+
+// ---------------------------------------------- other element types --
+
+// The other element types share one templated microkernel, compiled once
+// per instruction set with the register tile below. Complex operands are
+// packed with their real and imaginary parts in separate rows, so the
+// kernel only does real multiply-adds.
+enum class Width { kBase, kAvx2, kAvx512 };
+
+template <class T, Width width>
+struct Tile {
+  static constexpr int kMr = 4;
+  static constexpr int kNr = 4;
+};
+template <>
+struct Tile<float, Width::kBase> {
+  static constexpr int kMr = 4;
+  static constexpr int kNr = 8;
+};
+template <>
+struct Tile<float, Width::kAvx2> {
+  static constexpr int kMr = 6;
+  static constexpr int kNr = 16;
+};
+template <>
+struct Tile<float, Width::kAvx512> {
+  static constexpr int kMr = 8;
+  static constexpr int kNr = 32;
+};
+template <>
+struct Tile<std::complex<float>, Width::kAvx2> {
+  static constexpr int kMr = 4;
+  static constexpr int kNr = 8;
+};
+template <>
+struct Tile<std::complex<float>, Width::kAvx512> {
+  static constexpr int kMr = 4;
+  static constexpr int kNr = 16;
+};
+template <>
+struct Tile<std::complex<double>, Width::kBase> {
+  static constexpr int kMr = 4;
+  static constexpr int kNr = 2;
+};
+template <>
+struct Tile<std::complex<double>, Width::kAvx512> {
+  static constexpr int kMr = 4;
+  static constexpr int kNr = 8;
+};
+
+template <class R>
+R Re(R x) {
+  return x;
+}
+template <class R>
+R Re(const std::complex<R>& x) {
+  return x.real();
+}
+template <class R>
+R Im(R) {
+  return R(0);
+}
+template <class R>
+R Im(const std::complex<R>& x) {
+  return x.imag();
+}
+
+// Like PackA, with the imaginary parts of each step in a second row of mr.
+template <class T, int kMr>
+__attribute__((always_inline)) inline void PackASliver(
+    int mc, int kc, Operand<T> a, typename S21ScalarTraits<T>::Real* packed) {
+  using R = typename S21ScalarTraits<T>::Real;
+  for (int i = 0; i < mc; i += kMr) {
+    int rows = std::min(kMr, mc - i);
+    for (int p = 0; p < kc; p++) {
+      for (int r = 0; r < kMr; r++) {
+        *packed++ = r < rows ? Re(a(i + r, p)) : R(0);
+      }
+      if (S21ScalarTraits<T>::kComponents == 2) {
+        for (int r = 0; r < kMr; r++) {
+          *packed++ = r < rows ? Im(a(i + r, p)) : R(0);
+        }
+      }
+    }
+  }
+}
+
+template <class T, int kNr>
+__attribute__((always_inline)) inline void PackBSliver(
+    int kc, int nc, Operand<T> b, typename S21ScalarTraits<T>::Real* packed) {
+  using R = typename S21ScalarTraits<T>::Real;
+  for (int j = 0; j < nc; j += kNr) {
+    int cols = std::min(kNr, nc - j);
+    for (int p = 0; p < kc; p++) {
+      for (int c = 0; c < kNr; c++) {
+        *packed++ = c < cols ? Re(b(p, j + c)) : R(0);
+      }
+      if (S21ScalarTraits<T>::kComponents == 2) {
+        for (int c = 0; c < kNr; c++) {
+          *packed++ = c < cols ? Im(b(p, j + c)) : R(0);
+        }
+      }
+    }
+  }
+}
+
+// ab = packed A sliver * packed B sliver; for complex T the real parts go
+// to ab[0, mr * nr) and the imaginary parts after them.
+template <class T, int kMr, int kNr>
+__attribute__((always_inline)) inline void MicroKernel(
+    int kc, const typename S21ScalarTraits<T>::Real* a,
+    const typename S21ScalarTraits<T>::Real* b,
+    typename S21ScalarTraits<T>::Real* ab) {
+  using R = typename S21ScalarTraits<T>::Real;
+  if constexpr (S21ScalarTraits<T>::kComponents == 1) {
+    R acc[kMr][kNr] = {};
+    for (int p = 0; p < kc; p++, a += kMr, b += kNr) {
+      for (int r = 0; r < kMr; r++) {
+        for (int s = 0; s < kNr; s++) acc[r][s] += a[r] * b[s];
+      }
+    }
+    for (int r = 0; r < kMr; r++) {
+      for (int s = 0; s < kNr; s++) ab[r * kNr + s] = acc[r][s];
+    }
+  } else {
+    R re[kMr][kNr] = {};
+    R im[kMr][kNr] = {};
+    for (int p = 0; p < kc; p++, a += 2 * kMr, b += 2 * kNr) {
+      for (int r = 0; r < kMr; r++) {
+        for (int s = 0; s < kNr; s++) {
+          re[r][s] += a[r] * b[s] - a[kMr + r] * b[kNr + s];
+          im[r][s] += a[r] * b[kNr + s] + a[kMr + r] * b[s];
+        }
+      }
+    }
+    for (int r = 0; r < kMr; r++) {
+      for (int s = 0; s < kNr; s++) {
+        ab[r * kNr + s] = re[r][s];
+        ab[(kMr + r) * kNr + s] = im[r][s];
+      }
+    }
+  }
+}
+
+template <class T, int kMr, int kNr>
+__attribute__((always_inline)) inline void GemmBlocked(
+    int m, int n, int k, T alpha, Operand<T> a, Operand<T> b, T* c,
+    int ldc) {
+  using R = typename S21ScalarTraits<T>::Real;
+  constexpr int kComponents = S21ScalarTraits<T>::kComponents;
+  std::vector<R> packed_a(kComponents * RoundUp(std::min(m, kMc), kMr) *
+                          std::min(k, kKc));
+  std::vector<R> packed_b(kComponents * RoundUp(std::min(n, kNc), kNr) *
+                          std::min(k, kKc));
+  R ab[kComponents * kMr * kNr];
+  for (int jc = 0; jc < n; jc += kNc) {
+    int nc = std::min(kNc, n - jc);
+    for (int pc = 0; pc < k; pc += kKc) {
+      int kc = std::min(kKc, k - pc);
+      PackBSliver<T, kNr>(kc, nc, b.At(pc, jc), packed_b.data());
+      for (int ic = 0; ic < m; ic += kMc) {
+        int mc = std::min(kMc, m - ic);
+        PackASliver<T, kMr>(mc, kc, a.At(ic, pc), packed_a.data());
+        for (int j = 0; j < nc; j += kNr) {
+          int cols = std::min(kNr, nc - j);
+          for (int i = 0; i < mc; i += kMr) {
+            int rows = std::min(kMr, mc - i);
+            MicroKernel<T, kMr, kNr>(
+                kc, packed_a.data() + kComponents * i * kc,
+                packed_b.data() + kComponents * j * kc, ab);
+            for (int r = 0; r < rows; r++) {
+              T* out =
+                  c + static_cast<std::ptrdiff_t>(ic + i + r) * ldc + jc + j;
+              for (int s = 0; s < cols; s++) {
+                if constexpr (kComponents == 1) {
+                  out[s] += alpha * ab[r * kNr + s];
+                } else {
+                  out[s] += alpha * T(ab[r * kNr + s],
+                                      ab[(kMr + r) * kNr + s]);
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template <class T>
+void GemmBase(int m, int n, int k, T alpha, Operand<T> a, Operand<T> b, T* c,
+              int ldc) {
+  using Shape = Tile<T, Width::kBase>;
+  GemmBlocked<T, Shape::kMr, Shape::kNr>(m, n, k, alpha, a, b, c, ldc);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+template <class T>
+__attribute__((target("avx2,fma"))) void GemmAvx2(int m, int n, int k,
+                                                  T alpha, Operand<T> a,
+                                                  Operand<T> b, T* c,
+                                                  int ldc) {
+  using Shape = Tile<T, Width::kAvx2>;
+  GemmBlocked<T, Shape::kMr, Shape::kNr>(m, n, k, alpha, a, b, c, ldc);
+}
+
+template <class T>
+__attribute__((target("avx512f"))) void GemmAvx512(int m, int n, int k,
+                                                   T alpha, Operand<T> a,
+                                                   Operand<T> b, T* c,
+                                                   int ldc) {
+  using Shape = Tile<T, Width::kAvx512>;
+  GemmBlocked<T, Shape::kMr, Shape::kNr>(m, n, k, alpha, a, b, c, ldc);
+}
+
+#endif
+
+// S21Gemm for element type T, with the instruction set of S21GetKernels().
+template <class T>
+void GemmGeneric(int m, int n, int k, T alpha, Operand<T> a, Operand<T> b,
+                 T beta, T* c, int ldc) {
+  if (m <= 0 || n <= 0) return;
+  ScaleC(m, n, beta, c, ldc);
+  if (k <= 0 || alpha == T(0)) return;
+  auto serial = n <= kDotColumns ? GemmDots<T> : GemmBase<T>;
+#if defined(__x86_64__) || defined(__i386__)
+  // long double has no vector instructions to gain.
+  if (n > kDotColumns && !std::is_same<T, long double>::value) {
+    S21Isa isa = S21GetKernels().isa;
+    if (isa == S21Isa::kAvx512) {
+      serial = GemmAvx512<T>;
+    } else if (isa == S21Isa::kAvx2) {
+      serial = GemmAvx2<T>;
+    }
+  }
+#endif
+  Tiled(m, n, k, alpha, a, b, c, ldc, serial);
+}
+
+}  // namespace
+
+void S21Gemm(S21GemmOp op_a, S21GemmOp op_b, int m, int n, int k,
+             double alpha, const double* a, int lda, const double* b, int ldb,
+             double beta, double* c, int ldc) {
+  if (m <= 0 || n <= 0) return;
+  ScaleC(m, n, beta, c, ldc);
+  if (k <= 0 || alpha == 0.0) return;
+  Tiled(m, n, k, alpha, MakeOperand(op_a, a, lda), MakeOperand(op_b, b, ldb),
+        c, ldc, n <= kDotColumns ? GemmDots<double> : GemmSerial);
+}
+
+void S21Gemm(int m, int n, int k, double alpha, const double* a, int lda,
+             const double* b, int ldb, double beta, double* c, int ldc) {
+  S21Gemm(S21GemmOp::kNoTrans, S21GemmOp::kNoTrans, m, n, k, alpha, a, lda,
+          b, ldb, beta, c, ldc);
+}
+
+void S21Gemm(int m, int n, int k, float alpha, const float* a, int lda,
+             const float* b, int ldb, float beta, float* c, int ldc) {
+  GemmGeneric(m, n, k, alpha, MakeOperand(S21GemmOp::kNoTrans, a, lda),
+              MakeOperand(S21GemmOp::kNoTrans, b, ldb), beta, c, ldc);
+}
+
+void S21Gemm(int m, int n, int k, long double alpha, const long double* a,
+             int lda, const long double* b, int ldb, long double beta,
+             long double* c, int ldc) {
+  GemmGeneric(m, n, k, alpha, MakeOperand(S21GemmOp::kNoTrans, a, lda),
+              MakeOperand(S21GemmOp::kNoTrans, b, ldb), beta, c, ldc);
+}
+
+void S21Gemm(int m, int n, int k, std::complex<float> alpha,
+             const std::complex<float>* a, int lda,
+             const std::complex<float>* b, int ldb, std::complex<float> beta,
+             std::complex<float>* c, int ldc) {
+  GemmGeneric(m, n, k, alpha, MakeOperand(S21GemmOp::kNoTrans, a, lda),
+              MakeOperand(S21GemmOp::kNoTrans, b, ldb), beta, c, ldc);
+}
+
+void S21Gemm(int m, int n, int k, std::complex<double> alpha,
+             const std::complex<double>* a, int lda,
+             const std::complex<double>* b, int ldb,
+             std::complex<double> beta, std::complex<double>* c, int ldc) {
+  GemmGeneric(m, n, k, alpha, MakeOperand(S21GemmOp::kNoTrans, a, lda),
+              MakeOperand(S21GemmOp::kNoTrans, b, ldb), beta, c, ldc);
+}
@@ -0,0 +1,39 @@
+#ifndef SRC_S21_GEMM_H_
+#define SRC_S21_GEMM_H_
+
+#include <complex>
+
+// C = alpha * A * B + beta * C for row-major operands. A is m x k with
+// leading dimension lda, B is k x n with ldb and C is m x n with ldc. When
+// beta is 0 the previous contents of C are ignored, NaNs included.
+void S21Gemm(int m, int n, int k, double alpha, const double* a, int lda,
+             const double* b, int ldb, double beta, double* c, int ldc);
+
+// How S21Gemm reads an operand: as stored, or as the transpose of what is
+// stored. The transpose is read in place while the operand is packed, so it
+// costs no copy and runs at the speed of the plain product.
+enum class S21GemmOp { kNoTrans, kTrans };
+
+// C = alpha * op_a(A) * op_b(B) + beta * C. op_a(A) is m x k, so A is
+// stored m x k for kNoTrans and k x m for kTrans; likewise for B.
+void S21Gemm(S21GemmOp op_a, S21GemmOp op_b, int m, int n, int k,
+             double alpha, const double* a, int lda, const double* b, int ldb,
+             double beta, double* c, int ldc);
+
+// The same for the other element types BasicS21Matrix supports. float and
+// complex operands run on a vectorized kernel; long double is scalar.
+void S21Gemm(int m, int n, int k, float alpha, const float* a, int lda,
+             const float* b, int ldb, float beta, float* c, int ldc);
+void S21Gemm(int m, int n, int k, long double alpha, const long double* a,
+             int lda, const long double* b, int ldb, long double beta,
+             long double* c, int ldc);
+void S21Gemm(int m, int n, int k, std::complex<float> alpha,
+             const std::complex<float>* a, int lda,
+             const std::complex<float>* b, int ldb, std::complex<float> beta,
+             std::complex<float>* c, int ldc);
+void S21Gemm(int m, int n, int k, std::complex<double> alpha,
+             const std::complex<double>* a, int lda,
+             const std::complex<double>* b, int ldb,
+             std::complex<double> beta, std::complex<double>* c, int ldc);
+
+#endif  // SRC_S21_GEMM_H_
@@ -0,0 +1,181 @@
+#include "s21_instrument.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const char* const kOpNames[kS21OpCount] = {
+    "Copy",      "CopyAssign",      "SetRows",     "SetCols",
+    "EqMatrix",  "SumMatrix",       "SubMatrix",   "MulNumber",
+    "MulMatrix", "CalcComplements", "Determinant", "InverseMatrix",
+    "Axpy",      "Axpby",           "FusedMulAdd", "HadamardProduct",
+    "HadamardDivide",
+};
+
+// The counters of one thread. Only that thread writes them, so an update is
+// a relaxed load and store; the atomics only make concurrent snapshots
+// well-defined.
+struct Counters {
+  std::atomic<std::uint64_t> calls[kS21OpCount] = {};
+  std::atomic<std::uint64_t> flops[kS21OpCount] = {};
+  std::atomic<std::uint64_t> nanoseconds[kS21OpCount] = {};
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::uint64_t> bytes_allocated{0};
+  std::atomic<std::uint64_t> bytes_copied{0};
+};
+
+void Bump(std::atomic<std::uint64_t>* counter, std::uint64_t value) {
+  counter->store(counter->load(std::memory_order_relaxed) + value,
+                 std::memory_order_relaxed);
+}
+
+std::uint64_t Read(const std::atomic<std::uint64_t>& counter) {
+  return counter.load(std::memory_order_relaxed);
+}
+
+void AddCounters(const Counters& counters, S21InstrumentSnapshot* total) {
+  for (int op = 0; op < kS21OpCount; op++) {
+    total->ops[op].calls += Read(counters.calls[op]);
+    total->ops[op].flops += Read(counters.flops[op]);
+    total->ops[op].nanoseconds += Read(counters.nanoseconds[op]);
+  }
+  total->allocations += Read(counters.allocations);
+  total->bytes_allocated += Read(counters.bytes_allocated);
+  total->bytes_copied += Read(counters.bytes_copied);
+}
+
+void Subtract(const S21InstrumentSnapshot& b, S21InstrumentSnapshot* a) {
+  for (int op = 0; op < kS21OpCount; op++) {
+    a->ops[op].calls -= b.ops[op].calls;
+    a->ops[op].flops -= b.ops[op].flops;
+    a->ops[op].nanoseconds -= b.ops[op].nanoseconds;
+  }
+  a->allocations -= b.allocations;
+  a->bytes_allocated -= b.bytes_allocated;
+  a->bytes_copied -= b.bytes_copied;
+}
+
+// Live threads' counters, the totals of exited threads and the totals at
+// the last reset, all guarded by registry_mutex. Only thread start and exit,
+// snapshots and resets take it.
+std::mutex registry_mutex;
+std::vector<const Counters*> registry;
+S21InstrumentSnapshot retired = {};
+S21InstrumentSnapshot baseline = {};
+
+struct Registration {
+  Registration() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.push_back(&counters);
+  }
+  ~Registration() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    AddCounters(counters, &retired);
+    registry.erase(std::find(registry.begin(), registry.end(), &counters));
+  }
+  Counters counters;
+};
+
+Counters& LocalCounters() {
+  thread_local Registration registration;
+  return registration.counters;
+}
+
+// Sum of every thread's counters since the start; needs registry_mutex.
+S21InstrumentSnapshot Totals() {
+  S21InstrumentSnapshot total = retired;
+  for (const Counters* counters : registry) AddCounters(*counters, &total);
+  return total;
+}
+
+double Seconds(std::uint64_t nanoseconds) { return nanoseconds * 1e-9; }
+
+}  // namespace
+
+const char* S21OpName(S21Op op) { return kOpNames[static_cast<int>(op)]; }
+
+void S21CountOp(S21Op op, std::uint64_t flops, std::uint64_t nanoseconds) {
+  Counters& counters = LocalCounters();
+  int index = static_cast<int>(op);
+  Bump(&counters.calls[index], 1);
+  Bump(&counters.flops[index], flops);
+  Bump(&counters.nanoseconds[index], nanoseconds);
+}
+
+void S21CountAllocation(std::uint64_t bytes) {
+  Counters& counters = LocalCounters();
+  Bump(&counters.allocations, 1);
+  Bump(&counters.bytes_allocated, bytes);
+}
+
+void S21CountCopy(std::uint64_t bytes) {
+  Bump(&LocalCounters().bytes_copied, bytes);
+}
+
+S21InstrumentSnapshot S21GetInstrumentSnapshot() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  S21InstrumentSnapshot snapshot = Totals();
+  Subtract(baseline, &snapshot);
+  return snapshot;
+}
+
+void S21ResetInstrumentation() {
+  // Other threads may be counting, so rather than clearing their counters
+  // the reset moves the baseline snapshots are taken against.
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  baseline = Totals();
+}
+
+std::string S21InstrumentJson(const S21InstrumentSnapshot& snapshot) {
+  std::ostringstream out;
+  out.precision(9);
+  out << "{\"ops\": {";
+  for (int op = 0; op < kS21OpCount; op++) {
+    const S21OpCounters& counters = snapshot.ops[op];
+    out << (op > 0 ? ", " : "") << '"' << kOpNames[op] << "\": {\"calls\": "
+        << counters.calls << ", \"flops\": " << counters.flops
+        << ", \"seconds\": " << Seconds(counters.nanoseconds) << '}';
+  }
+  out << "}, \"allocations\": " << snapshot.allocations
+      << ", \"bytes_allocated\": " << snapshot.bytes_allocated
+      << ", \"bytes_copied\": " << snapshot.bytes_copied << '}';
+  return out.str();
+}
+
+std::string S21InstrumentPrometheus(const S21InstrumentSnapshot& snapshot) {
+  std::ostringstream out;
+  out.precision(9);
+  auto header = [&out](const char* name, const char* help) {
+    out << "# HELP " << name << ' ' << help << "\n# TYPE " << name
+        << " counter\n";
+  };
+  auto per_op = [&](const char* name, const char* help, auto value) {
+    header(name, help);
+    for (int op = 0; op < kS21OpCount; op++) {
+      out << name << "{op=\"" << kOpNames[op] << "\"} "
+          << value(snapshot.ops[op]) << '\n';
+    }
+  };
+  per_op("s21_matrix_op_calls_total", "Calls of each S21Matrix operation.",
+         [](const S21OpCounters& c) { return c.calls; });
+  per_op("s21_matrix_op_flops_total",
+         "Nominal floating-point operations of each S21Matrix operation.",
+         [](const S21OpCounters& c) { return c.flops; });
+  per_op("s21_matrix_op_seconds_total",
+         "Wall time spent in each S21Matrix operation.",
+         [](const S21OpCounters& c) { return Seconds(c.nanoseconds); });
+  header("s21_matrix_allocations_total", "Buffers allocated by S21Matrix.");
+  out << "s21_matrix_allocations_total " << snapshot.allocations << '\n';
+  header("s21_matrix_allocated_bytes_total",
+         "Bytes allocated by S21Matrix, row padding included.");
+  out << "s21_matrix_allocated_bytes_total " << snapshot.bytes_allocated
+      << '\n';
+  header("s21_matrix_copied_bytes_total",
+         "Bytes copied by S21Matrix copies, assignments and resizes.");
+  out << "s21_matrix_copied_bytes_total " << snapshot.bytes_copied << '\n';
+  return out.str();
+}
@@ -0,0 +1,114 @@
+#ifndef SRC_S21_INSTRUMENT_H_
+#define SRC_S21_INSTRUMENT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Counters of what S21Matrix spends its time and memory on. They are only
+// collected when the library is built with S21_MATRIX_INSTRUMENT defined
+// (make INSTRUMENT=1 ...); otherwise the hooks below expand to nothing and
+// every snapshot is zero.
+//
+// Each thread counts into its own block with plain relaxed stores, so the
+// hot paths take no lock and share no cache line. A snapshot sums the
+// blocks of the live threads and what exited threads left behind.
+#ifdef S21_MATRIX_INSTRUMENT
+constexpr bool kS21Instrumented = true;
+#else
+constexpr bool kS21Instrumented = false;
+#endif
+
+// The instrumented operations.
+enum class S21Op {
+  kCopy,        // copy constructor
+  kCopyAssign,  // copy assignment
+  kSetRows,
+  kSetCols,
+  kEqMatrix,
+  kSumMatrix,
+  kSubMatrix,
+  kMulNumber,
+  kMulMatrix,
+  kCalcComplements,
+  kDeterminant,
+  kInverseMatrix,
+  kAxpy,
+  kAxpby,
+  kFusedMulAdd,
+  kHadamardProduct,
+  kHadamardDivide,
+};
+constexpr int kS21OpCount = static_cast<int>(S21Op::kHadamardDivide) + 1;
+
+// "MulMatrix" for S21Op::kMulMatrix, and so on.
+const char* S21OpName(S21Op op);
+
+// flops are nominal: one per element for the elementwise operations, two
+// for Axpy and FusedMulAdd and three for Axpby, 2mnk for a product,
+// 2n^3 / 3 for a determinant and 2n^3 for an inverse or complements. Times
+// are wall time and include nested operations.
+struct S21OpCounters {
+  std::uint64_t calls;
+  std::uint64_t flops;
+  std::uint64_t nanoseconds;
+};
+
+struct S21InstrumentSnapshot {
+  S21OpCounters ops[kS21OpCount];
+  std::uint64_t allocations;      // buffers allocated by S21Matrix
+  std::uint64_t bytes_allocated;  // their size, row padding included
+  std::uint64_t bytes_copied;     // by copies, assignments and resizes
+};
+
+// Counters since the start of the process or the last reset.
+S21InstrumentSnapshot S21GetInstrumentSnapshot();
+void S21ResetInstrumentation();
+
+// {"ops": {"MulMatrix": {"calls": 1, "flops": 2, "seconds": 1e-06}, ...},
+//  "allocations": 1, "bytes_allocated": 64, "bytes_copied": 0}
+std::string S21InstrumentJson(const S21InstrumentSnapshot& snapshot);
+// Prometheus text exposition format: s21_matrix_op_calls_total{op="..."},
+// s21_matrix_op_flops_total, s21_matrix_op_seconds_total,
+// s21_matrix_allocations_total, s21_matrix_allocated_bytes_total and
+// s21_matrix_copied_bytes_total.
+std::string S21InstrumentPrometheus(const S21InstrumentSnapshot& snapshot);
+
+// Hooks, called through the macros below.
+void S21CountOp(S21Op op, std::uint64_t flops, std::uint64_t nanoseconds);
+void S21CountAllocation(std::uint64_t bytes);
+void S21CountCopy(std::uint64_t bytes);
+
+// Times the enclosing scope as one call of op.
+class S21OpScope {
+ public:
+  S21OpScope(S21Op op, double flops)
+      : op_(op),
+        flops_(static_cast<std::uint64_t>(flops)),
+        start_(std::chrono::steady_clock::now()) {}
+  S21OpScope(const S21OpScope&) = delete;
+  S21OpScope& operator=(const S21OpScope&) = delete;
+  ~S21OpScope() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    S21CountOp(op_, flops_,
+               std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                   .count());
+  }
+
+ private:
+  S21Op op_;
+  std::uint64_t flops_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+#ifdef S21_MATRIX_INSTRUMENT
+#define S21_INSTRUMENT_OP(op, flops) S21OpScope s21_op_scope_(op, flops)
+#define S21_INSTRUMENT_ALLOC(bytes) S21CountAllocation(bytes)
+#define S21_INSTRUMENT_COPY(bytes) S21CountCopy(bytes)
+#else
+#define S21_INSTRUMENT_OP(op, flops) ((void)0)
+#define S21_INSTRUMENT_ALLOC(bytes) ((void)0)
+#define S21_INSTRUMENT_COPY(bytes) ((void)0)
+#endif
+
+#endif  // SRC_S21_INSTRUMENT_H_
@@ -0,0 +1,231 @@
+#include "s21_lu.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "s21_gemm.h"
+#include "s21_scalar.h"
+
+namespace {
+
+// Columns factored per panel before the trailing matrix is updated with one
+// GEMM call.
+constexpr int kPanel = 64;
+
+template <class T>
+int LuFactor(int n, T* a, int lda, int* piv) {
+  using Real = typename S21ScalarTraits<T>::Real;
+  // A pivot within rounding noise of both its row and its column of A is
+  // taken as zero, as left by cancellation when the rows of A are linearly
+  // dependent. Scaling per row and column keeps diag(1e300, 1) regular.
+  std::vector<Real> row_scale(n, Real(0)), col_scale(n, Real(0));
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      Real magnitude = S21Magnitude(a[i * lda + j]);
+      row_scale[i] = std::max(row_scale[i], magnitude);
+      col_scale[j] = std::max(col_scale[j], magnitude);
+    }
+  }
+  int sign = 1;
+  for (int j0 = 0; sign != 0 && j0 < n; j0 += kPanel) {
+    int jb = std::min(kPanel, n - j0);
+    // Unblocked right-looking LU of the panel; pivots swap whole rows, which
+    // also applies them to the factored and trailing parts.
+    for (int j = j0; sign != 0 && j < j0 + jb; j++) {
+      int p = j;
+      for (int i = j + 1; i < n; i++) {
+        if (S21Magnitude(a[i * lda + j]) > S21Magnitude(a[p * lda + j])) {
+          p = i;
+        }
+      }
+      piv[j] = p;
+      if (S21Magnitude(a[p * lda + j]) <=
+          S21PivotTolerance(n, std::min(row_scale[p], col_scale[j]))) {
+        sign = 0;
+      } else {
+        if (p != j) {
+          std::swap_ranges(a + j * lda, a + j * lda + n, a + p * lda);
+          std::swap(row_scale[j], row_scale[p]);
+          sign = -sign;
+        }
+        const T* pivot_row = a + j * lda;
+        for (int i = j + 1; i < n; i++) {
+          T* row = a + i * lda;
+          T l = row[j] /= pivot_row[j];
+          for (int c = j + 1; c < j0 + jb; c++) {
+            row[c] -= l * pivot_row[c];
+          }
+        }
+      }
+    }
+    int rest = n - j0 - jb;
+    if (sign != 0 && rest > 0) {
+      // U12 = L11^-1 * A12, then A22 -= L21 * U12.
+      for (int i = j0 + 1; i < j0 + jb; i++) {
+        T* row = a + i * lda + j0 + jb;
+        for (int p = j0; p < i; p++) {
+          T l = a[i * lda + p];
+          const T* upper = a + p * lda + j0 + jb;
+          for (int c = 0; c < rest; c++) {
+            row[c] -= l * upper[c];
+          }
+        }
+      }
+      S21Gemm(rest, rest, jb, T(-1), a + (j0 + jb) * lda + j0, lda,
+              a + j0 * lda + j0 + jb, lda, T(1), a + (j0 + jb) * lda + j0 + jb,
+              lda);
+    }
+  }
+  return sign;
+}
+
+template <class T>
+void LuSolve(int n, const T* lu, int lda, const int* piv, int nrhs, T* b,
+             int ldb) {
+  for (int i = 0; i < n; i++) {
+    if (piv[i] != i) {
+      std::swap_ranges(b + i * ldb, b + i * ldb + nrhs, b + piv[i] * ldb);
+    }
+  }
+  // Forward substitution with the unit lower triangle, one diagonal block of
+  // rows at a time; the rows below each block are updated by one GEMM.
+  for (int i0 = 0; i0 < n; i0 += kPanel) {
+    int ib = std::min(kPanel, n - i0);
+    for (int i = i0 + 1; i < i0 + ib; i++) {
+      T* row = b + i * ldb;
+      for (int p = i0; p < i; p++) {
+        T l = lu[i * lda + p];
+        const T* solved = b + p * ldb;
+        for (int c = 0; c < nrhs; c++) {
+          row[c] -= l * solved[c];
+        }
+      }
+    }
+    int rest = n - i0 - ib;
+    if (rest > 0) {
+      S21Gemm(rest, nrhs, ib, T(-1), lu + (i0 + ib) * lda + i0, lda,
+              b + i0 * ldb, ldb, T(1), b + (i0 + ib) * ldb, ldb);
+    }
+  }
+  // Backward substitution with U, bottom block first.
+  for (int i1 = n; i1 > 0; i1 -= kPanel) {
+    int i0 = std::max(0, i1 - kPanel);
+    for (int i = i1 - 1; i >= i0; i--) {
+      T* row = b + i * ldb;
+      for (int p = i + 1; p < i1; p++) {
+        T u = lu[i * lda + p];
+        const T* solved = b + p * ldb;
+        for (int c = 0; c < nrhs; c++) {
+          row[c] -= u * solved[c];
+        }
+      }
+      T diagonal = lu[i * lda + i];
+      for (int c = 0; c < nrhs; c++) {
+        row[c] /= diagonal;
+      }
+    }
+    if (i0 > 0) {
+      S21Gemm(i0, nrhs, i1 - i0, T(-1), lu + i0, lda, b + i0 * ldb, ldb, T(1),
+              b, ldb);
+    }
+  }
+}
+
+}  // namespace
+
+// A^T = U^T * L^T * P: forward substitution with U^T, backward substitution
+// with the unit upper triangle L^T, then the row swaps undone in reverse.
+// The triangles are read transposed in place, the blocks by S21Gemm.
+void S21LuSolveTransposed(int n, const double* lu, int lda, const int* piv,
+                          int nrhs, double* b, int ldb) {
+  for (int i0 = 0; i0 < n; i0 += kPanel) {
+    int ib = std::min(kPanel, n - i0);
+    for (int i = i0; i < i0 + ib; i++) {
+      double* row = b + i * ldb;
+      for (int p = i0; p < i; p++) {
+        double u = lu[p * lda + i];
+        const double* solved = b + p * ldb;
+        for (int c = 0; c < nrhs; c++) {
+          row[c] -= u * solved[c];
+        }
+      }
+      double diagonal = lu[i * lda + i];
+      for (int c = 0; c < nrhs; c++) {
+        row[c] /= diagonal;
+      }
+    }
+    int rest = n - i0 - ib;
+    if (rest > 0) {
+      S21Gemm(S21GemmOp::kTrans, S21GemmOp::kNoTrans, rest, nrhs, ib, -1.0,
+              lu + i0 * lda + i0 + ib, lda, b + i0 * ldb, ldb, 1.0,
+              b + (i0 + ib) * ldb, ldb);
+    }
+  }
+  for (int i1 = n; i1 > 0; i1 -= kPanel) {
+    int i0 = std::max(0, i1 - kPanel);
+    for (int i = i1 - 1; i >= i0; i--) {
+      double* row = b + i * ldb;
+      for (int p = i + 1; p < i1; p++) {
+        double l = lu[p * lda + i];
+        const double* solved = b + p * ldb;
+        for (int c = 0; c < nrhs; c++) {
+          row[c] -= l * solved[c];
+        }
+      }
+    }
+    if (i0 > 0) {
+      S21Gemm(S21GemmOp::kTrans, S21GemmOp::kNoTrans, i0, nrhs, i1 - i0, -1.0,
+              lu + i0 * lda, lda, b + i0 * ldb, ldb, 1.0, b, ldb);
+    }
+  }
+  for (int i = n - 1; i >= 0; i--) {
+    if (piv[i] != i) {
+      std::swap_ranges(b + i * ldb, b + i * ldb + nrhs, b + piv[i] * ldb);
+    }
+  }
+}
+
+int S21LuFactor(int n, double* a, int lda, int* piv) {
+  return LuFactor(n, a, lda, piv);
+}
+
+int S21LuFactor(int n, float* a, int lda, int* piv) {
+  return LuFactor(n, a, lda, piv);
+}
+
+int S21LuFactor(int n, long double* a, int lda, int* piv) {
+  return LuFactor(n, a, lda, piv);
+}
+
+int S21LuFactor(int n, std::complex<float>* a, int lda, int* piv) {
+  return LuFactor(n, a, lda, piv);
+}
+
+int S21LuFactor(int n, std::complex<double>* a, int lda, int* piv) {
+  return LuFactor(n, a, lda, piv);
+}
+
+void S21LuSolve(int n, const double* lu, int lda, const int* piv, int nrhs,
+                double* b, int ldb) {
+  LuSolve(n, lu, lda, piv, nrhs, b, ldb);
+}
+
+void S21LuSolve(int n, const float* lu, int lda, const int* piv, int nrhs,
+                float* b, int ldb) {
+  LuSolve(n, lu, lda, piv, nrhs, b, ldb);
+}
+
+void S21LuSolve(int n, const long double* lu, int lda, const int* piv,
+                int nrhs, long double* b, int ldb) {
+  LuSolve(n, lu, lda, piv, nrhs, b, ldb);
+}
+
+void S21LuSolve(int n, const std::complex<float>* lu, int lda, const int* piv,
+                int nrhs, std::complex<float>* b, int ldb) {
+  LuSolve(n, lu, lda, piv, nrhs, b, ldb);
+}
+
+void S21LuSolve(int n, const std::complex<double>* lu, int lda,
+                const int* piv, int nrhs, std::complex<double>* b, int ldb) {
+  LuSolve(n, lu, lda, piv, nrhs, b, ldb);
+}
@@ -0,0 +1,40 @@
+#ifndef SRC_S21_LU_H_
+#define SRC_S21_LU_H_
+
+#include <complex>
+
+// Factors the n x n row-major matrix a (leading dimension lda) in place into
+// P * A = L * U with partial pivoting. L is unit lower triangular and stored
+// below the diagonal, U on and above it; row i was swapped with row piv[i].
+// Returns the sign of the permutation, or 0 as soon as a column has no pivot
+// above n * epsilon times the largest |a_ij| of both its row and its column,
+// leaving a partially factored and piv partially filled.
+int S21LuFactor(int n, double* a, int lda, int* piv);
+
+// Overwrites the n x nrhs row-major matrix b with the solution X of
+// A * X = b, where lu and piv hold a complete factorization of A from
+// S21LuFactor.
+void S21LuSolve(int n, const double* lu, int lda, const int* piv, int nrhs,
+                double* b, int ldb);
+
+// Overwrites b with the solution X of A^T * X = b from the same
+// factorization of A, so A^T is never formed or factored.
+void S21LuSolveTransposed(int n, const double* lu, int lda, const int* piv,
+                          int nrhs, double* b, int ldb);
+
+// The same for the other element types BasicS21Matrix supports. Complex
+// pivots are chosen by |re| + |im|.
+int S21LuFactor(int n, float* a, int lda, int* piv);
+int S21LuFactor(int n, long double* a, int lda, int* piv);
+int S21LuFactor(int n, std::complex<float>* a, int lda, int* piv);
+int S21LuFactor(int n, std::complex<double>* a, int lda, int* piv);
+void S21LuSolve(int n, const float* lu, int lda, const int* piv, int nrhs,
+                float* b, int ldb);
+void S21LuSolve(int n, const long double* lu, int lda, const int* piv,
+                int nrhs, long double* b, int ldb);
+void S21LuSolve(int n, const std::complex<float>* lu, int lda, const int* piv,
+                int nrhs, std::complex<float>* b, int ldb);
+void S21LuSolve(int n, const std::complex<double>* lu, int lda,
+                const int* piv, int nrhs, std::complex<double>* b, int ldb);
+
+#endif  // SRC_S21_LU_H_
@@ -0,0 +1,535 @@
+#include "s21_matrix_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "s21_allocator.h"
+#include "s21_scalar.h"
+#include "s21_simd.h"
+#include "s21_thread_pool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_BATCH_X86 1
+#endif
+
+namespace {
+
+constexpr int kLanes = kS21BatchLanes;
+// Roughly the flops one thread-pool task should get; smaller batches run on
+// the calling thread.
+constexpr int kTaskWork = 1 << 16;
+
+// One element of kLanes members. Every operation is a loop with a constant
+// trip count and no dependencies, which compiles to a few SIMD instructions.
+struct Lanes {
+  double v[kLanes];
+};
+
+inline Lanes Load(const double* p) {
+  Lanes res;
+  for (int l = 0; l < kLanes; l++) res.v[l] = p[l];
+  return res;
+}
+
+inline void Store(const Lanes& x, double* p) {
+  for (int l = 0; l < kLanes; l++) p[l] = x.v[l];
+}
+
+inline Lanes Splat(double x) {
+  Lanes res;
+  for (int l = 0; l < kLanes; l++) res.v[l] = x;
+  return res;
+}
+
+inline Lanes operator+(const Lanes& x, const Lanes& y) {
+  Lanes res;
+  for (int l = 0; l < kLanes; l++) res.v[l] = x.v[l] + y.v[l];
+  return res;
+}
+
+inline Lanes operator-(const Lanes& x, const Lanes& y) {
+  Lanes res;
+  for (int l = 0; l < kLanes; l++) res.v[l] = x.v[l] - y.v[l];
+  return res;
+}
+
+inline Lanes operator*(const Lanes& x, const Lanes& y) {
+  Lanes res;
+  for (int l = 0; l < kLanes; l++) res.v[l] = x.v[l] * y.v[l];
+  return res;
+}
+
+// 1 / x, and 0 in the lanes where x is 0.
+inline Lanes Reciprocal(const Lanes& x) {
+  Lanes res;
+  for (int l = 0; l < kLanes; l++) {
+    double inverse = 1.0 / (x.v[l] != 0.0 ? x.v[l] : 1.0);
+    res.v[l] = x.v[l] != 0.0 ? inverse : 0.0;
+  }
+  return res;
+}
+
+// 1 in the lanes where x is 0, flags elsewhere.
+inline Lanes FlagZero(const Lanes& x, const Lanes& flags) {
+  Lanes res;
+  for (int l = 0; l < kLanes; l++) res.v[l] = x.v[l] == 0.0 ? 1.0 : flags.v[l];
+  return res;
+}
+
+// max(x, |y|) per lane.
+inline Lanes AbsMax(const Lanes& x, const Lanes& y) {
+  Lanes res;
+  for (int l = 0; l < kLanes; l++) {
+    double magnitude = std::fabs(y.v[l]);
+    res.v[l] = x.v[l] > magnitude ? x.v[l] : magnitude;
+  }
+  return res;
+}
+
+// Per lane, the largest |a(i, j)| of each row i into rows + i * kLanes and
+// of each column j into cols + j * kLanes.
+template <class Element>
+inline void Scales(int n, const Element& a, double* rows, double* cols) {
+  for (int i = 0; i < n; i++) {
+    Lanes row = Splat(0.0);
+    Lanes col = Splat(0.0);
+    for (int j = 0; j < n; j++) {
+      row = AbsMax(row, Load(a(i, j)));
+      col = AbsMax(col, Load(a(j, i)));
+    }
+    Store(row, rows + i * kLanes);
+    Store(col, cols + i * kLanes);
+  }
+}
+
+// The pivot x, zeroed in the lanes where it is rounding noise at the scale
+// of both its row and its column, as in S21LuFactor.
+inline Lanes DropNoise(int n, const Lanes& x, const double* row,
+                       const double* col) {
+  Lanes res;
+  for (int l = 0; l < kLanes; l++) {
+    double tolerance = S21PivotTolerance(n, std::min(row[l], col[l]));
+    res.v[l] = std::fabs(x.v[l]) <= tolerance ? 0.0 : x.v[l];
+  }
+  return res;
+}
+
+// Row index, per lane, of the largest |a(i, col)| for i >= col; a(i, j) gives
+// the address of an element's lanes.
+template <class Element>
+inline Lanes PivotRows(int n, int col, const Element& a) {
+  Lanes best = Load(a(col, col));
+  Lanes pivot = Splat(col);
+  for (int l = 0; l < kLanes; l++) best.v[l] = std::fabs(best.v[l]);
+  for (int i = col + 1; i < n; i++) {
+    Lanes value = Load(a(i, col));
+    for (int l = 0; l < kLanes; l++) {
+      double candidate = std::fabs(value.v[l]);
+      bool better = candidate > best.v[l];
+      best.v[l] = better ? candidate : best.v[l];
+      pivot.v[l] = better ? i : pivot.v[l];
+    }
+  }
+  return pivot;
+}
+
+// Exchanges *x and *y in the lanes where pivot is row.
+inline void SwapWhere(const Lanes& pivot, int row, double* x, double* y) {
+  Lanes top = Load(x);
+  Lanes bottom = Load(y);
+  for (int l = 0; l < kLanes; l++) {
+    bool swap = pivot.v[l] == row;
+    double keep = top.v[l];
+    top.v[l] = swap ? bottom.v[l] : top.v[l];
+    bottom.v[l] = swap ? keep : bottom.v[l];
+  }
+  Store(top, x);
+  Store(bottom, y);
+}
+
+// Calls body(block) for every block in [begin, end). Bodies are always
+// inlined, so the target variants below compile their lane loops for the
+// wider registers.
+template <class Body>
+void ForBlocks(int begin, int end, const Body& body) {
+  for (int block = begin; block < end; block++) body(block);
+}
+
+#ifdef S21_BATCH_X86
+
+template <class Body>
+__attribute__((target("avx2,fma"))) void ForBlocksAvx2(int begin, int end,
+                                                       const Body& body) {
+  for (int block = begin; block < end; block++) body(block);
+}
+
+template <class Body>
+__attribute__((target("avx512f"))) void ForBlocksAvx512(int begin, int end,
+                                                        const Body& body) {
+  for (int block = begin; block < end; block++) body(block);
+}
+
+#endif  // S21_BATCH_X86
+
+// Runs body over blocks lane blocks, each costing about work flops per
+// member, with the instruction set of S21GetKernels() and spread over
+// S21ThreadPool.
+template <class Body>
+void RunBlocks(int blocks, int work, const Body& body) {
+  S21Isa isa = S21GetKernels().isa;
+  auto run = [&](int begin, int end) {
+#ifdef S21_BATCH_X86
+    if (isa == S21Isa::kAvx512) {
+      ForBlocksAvx512(begin, end, body);
+    } else if (isa == S21Isa::kAvx2) {
+      ForBlocksAvx2(begin, end, body);
+    } else {
+      ForBlocks(begin, end, body);
+    }
+#else
+    (void)isa;
+    ForBlocks(begin, end, body);
+#endif
+  };
+  int per_task = std::max(1, kTaskWork / (std::max(work, 1) * kLanes));
+  int tasks = (blocks + per_task - 1) / per_task;
+  if (tasks > 1) {
+    S21ThreadPool::Instance().ParallelFor(tasks, [&](int task) {
+      int begin = task * per_task;
+      run(begin, std::min(blocks, begin + per_task));
+    });
+  } else {
+    run(0, blocks);
+  }
+}
+
+}  // namespace
+
+S21MatrixBatch::S21MatrixBatch(int count, int rows, int cols)
+    : count_(count), rows_(rows), cols_(cols), data_(nullptr) {
+  if (count < 1 || rows < 1 || cols < 1) {
+    throw std::logic_error("Wrong size of the Matrix");
+  }
+  blocks_ = (count + kLanes - 1) / kLanes;
+  data_ = S21AllocateBuffer(Size());
+  std::fill(data_, data_ + Size(), 0.0);
+}
+
+S21MatrixBatch::S21MatrixBatch(const S21MatrixBatch& other)
+    : S21MatrixBatch(other.count_, other.rows_, other.cols_) {
+  std::copy(other.data_, other.data_ + Size(), data_);
+}
+
+S21MatrixBatch::S21MatrixBatch(S21MatrixBatch&& other) noexcept
+    : count_(other.count_),
+      rows_(other.rows_),
+      cols_(other.cols_),
+      blocks_(other.blocks_),
+      data_(other.data_) {
+  other.count_ = 0;
+  other.rows_ = 0;
+  other.cols_ = 0;
+  other.blocks_ = 0;
+  other.data_ = nullptr;
+}
+
+S21MatrixBatch& S21MatrixBatch::operator=(const S21MatrixBatch& other) {
+  if (this != &other) {
+    *this = S21MatrixBatch(other);
+  }
+  return *this;
+}
+
+S21MatrixBatch& S21MatrixBatch::operator=(S21MatrixBatch&& other) noexcept {
+  if (this != &other) {
+    S21FreeBuffer(data_);
+    count_ = other.count_;
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    blocks_ = other.blocks_;
+    data_ = other.data_;
+    other.count_ = 0;
+    other.rows_ = 0;
+    other.cols_ = 0;
+    other.blocks_ = 0;
+    other.data_ = nullptr;
+  }
+  return *this;
+}
+
+S21MatrixBatch::~S21MatrixBatch() { S21FreeBuffer(data_); }
+
+double& S21MatrixBatch::operator()(int index, int i, int j) {
+  CheckIndex(index, i, j);
+  return Element(index / kLanes, i, j)[index % kLanes];
+}
+
+double S21MatrixBatch::operator()(int index, int i, int j) const {
+  CheckIndex(index, i, j);
+  return Element(index / kLanes, i, j)[index % kLanes];
+}
+
+S21Matrix S21MatrixBatch::Get(int index) const {
+  CheckIndex(index, 0, 0);
+  S21Matrix matrix(rows_, cols_);
+  const double* lane = Element(index / kLanes, 0, 0) + index % kLanes;
+  for (int i = 0; i < rows_; i++) {
+    double* row = matrix.MutableData() +
+                  static_cast<std::ptrdiff_t>(i) * matrix.Stride();
+    for (int j = 0; j < cols_; j++) row[j] = lane[(i * cols_ + j) * kLanes];
+  }
+  return matrix;
+}
+
+void S21MatrixBatch::Set(int index, const S21ConstMatrixView& matrix) {
+  CheckIndex(index, 0, 0);
+  if (matrix.GetRows() != rows_ || matrix.GetCols() != cols_) {
+    throw std::logic_error("Matrix sizes are not identical\n");
+  }
+  double* lane = Element(index / kLanes, 0, 0) + index % kLanes;
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      lane[(i * cols_ + j) * kLanes] = matrix.At(i, j);
+    }
+  }
+}
+
+bool S21MatrixBatch::EqMatrix(const S21MatrixBatch& other) const {
+  static const double EPS = 0.0000001;
+  CheckSameSize(other);
+  // Padding is zero in both batches, so one flat pass suffices.
+  return S21GetKernels().equal(Size(), data_, other.data_, EPS);
+}
+
+void S21MatrixBatch::SumMatrix(const S21MatrixBatch& other) {
+  CheckSameSize(other);
+  S21GetKernels().add(Size(), other.data_, data_);
+}
+
+void S21MatrixBatch::SubMatrix(const S21MatrixBatch& other) {
+  CheckSameSize(other);
+  S21GetKernels().sub(Size(), other.data_, data_);
+}
+
+void S21MatrixBatch::MulNumber(double num) {
+  S21GetKernels().scale(Size(), num, data_);
+  // An infinite num turns the zero padding into NaN.
+  ClearPadding();
+}
+
+void S21MatrixBatch::MulMatrix(const S21MatrixBatch& other) {
+  if (count_ != other.count_) {
+    throw std::logic_error("Batch sizes are not identical\n");
+  }
+  if (cols_ != other.rows_) {
+    throw std::out_of_range(
+        "the number of columns of the first matrix does not equal the number "
+        "of rows of the second matrix\n");
+  }
+  S21MatrixBatch result(count_, rows_, other.cols_);
+  auto body = [&](int block) __attribute__((always_inline)) {
+    for (int i = 0; i < result.rows_; i++) {
+      for (int j = 0; j < result.cols_; j++) {
+        Lanes sum = Splat(0.0);
+        for (int p = 0; p < cols_; p++) {
+          sum = sum + Load(Element(block, i, p)) *
+                          Load(other.Element(block, p, j));
+        }
+        Store(sum, result.Element(block, i, j));
+      }
+    }
+  };
+  RunBlocks(blocks_, 2 * rows_ * cols_ * other.cols_, body);
+  *this = std::move(result);
+}
+
+S21MatrixBatch S21MatrixBatch::Transpose() const {
+  S21MatrixBatch result(count_, cols_, rows_);
+  for (int block = 0; block < blocks_; block++) {
+    for (int i = 0; i < rows_; i++) {
+      for (int j = 0; j < cols_; j++) {
+        Store(Load(Element(block, i, j)), result.Element(block, j, i));
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<double> S21MatrixBatch::Determinant() const {
+  if (rows_ != cols_) {
+    throw std::logic_error("Matrix is not square\n");
+  }
+  std::vector<double> det(static_cast<std::size_t>(blocks_) * kLanes);
+  int n = rows_;
+  if (n <= 3) {
+    // Cofactor expansion, exact for integer entries like S21Matrix.
+    auto body = [&](int block) __attribute__((always_inline)) {
+      auto a = [&](int i, int j) { return Load(Element(block, i, j)); };
+      Lanes res = a(0, 0);
+      if (n == 2) {
+        res = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+      } else if (n == 3) {
+        res = a(0, 0) * (a(1, 1) * a(2, 2) - a(1, 2) * a(2, 1)) -
+              a(0, 1) * (a(1, 0) * a(2, 2) - a(1, 2) * a(2, 0)) +
+              a(0, 2) * (a(1, 0) * a(2, 1) - a(1, 1) * a(2, 0));
+      }
+      Store(res, det.data() + block * kLanes);
+    };
+    RunBlocks(blocks_, 3 * n * n, body);
+  } else {
+    S21MatrixBatch lu(*this);
+    std::vector<double> scales(static_cast<std::size_t>(blocks_) * 2 * n *
+                               kLanes);
+    auto body = [&](int block) __attribute__((always_inline)) {
+      auto a = [&](int i, int j) { return lu.Element(block, i, j); };
+      double* row_scale = scales.data() + block * 2 * n * kLanes;
+      double* col_scale = row_scale + n * kLanes;
+      Scales(n, a, row_scale, col_scale);
+      Lanes res = Splat(1.0);
+      for (int k = 0; k < n; k++) {
+        Lanes pivot = PivotRows(n, k, a);
+        for (int i = k + 1; i < n; i++) {
+          for (int j = k; j < n; j++) SwapWhere(pivot, i, a(k, j), a(i, j));
+          SwapWhere(pivot, i, row_scale + k * kLanes, row_scale + i * kLanes);
+        }
+        Lanes diagonal = DropNoise(n, Load(a(k, k)), row_scale + k * kLanes,
+                                   col_scale + k * kLanes);
+        for (int l = 0; l < kLanes; l++) {
+          res.v[l] *= pivot.v[l] != k ? -diagonal.v[l] : diagonal.v[l];
+        }
+        // A zero or noise pivot has already zeroed the determinant; its
+        // reciprocal is 0 so the lane carries on without producing NaN.
+        Lanes scale = Reciprocal(diagonal);
+        for (int i = k + 1; i < n; i++) {
+          Lanes factor = Load(a(i, k)) * scale;
+          for (int j = k + 1; j < n; j++) {
+            Store(Load(a(i, j)) - factor * Load(a(k, j)), a(i, j));
+          }
+        }
+      }
+      Store(res, det.data() + block * kLanes);
+    };
+    RunBlocks(blocks_, 2 * n * n * n / 3 + n * n * n / 2, body);
+  }
+  det.resize(count_);
+  return det;
+}
+
+S21MatrixBatch S21MatrixBatch::InverseMatrix() const {
+  if (rows_ != cols_) {
+    throw std::logic_error("Matrix is not square\n");
+  }
+  int n = rows_;
+  S21MatrixBatch inverse(count_, n, n);
+  // 1 in the lanes of singular members.
+  std::vector<double> singular(static_cast<std::size_t>(blocks_) * kLanes);
+  if (n <= 3) {
+    // adj(A) / det(A). For 3 x 3 the cyclic index shifts give each cofactor
+    // its sign.
+    auto body = [&](int block) __attribute__((always_inline)) {
+      auto a = [&](int i, int j) { return Load(Element(block, i, j)); };
+      auto out = [&](int i, int j) { return inverse.Element(block, i, j); };
+      Lanes det = a(0, 0);
+      if (n == 1) {
+        Store(Reciprocal(det), out(0, 0));
+      } else if (n == 2) {
+        det = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+        Lanes scale = Reciprocal(det);
+        Store(a(1, 1) * scale, out(0, 0));
+        Store(Splat(0.0) - a(0, 1) * scale, out(0, 1));
+        Store(Splat(0.0) - a(1, 0) * scale, out(1, 0));
+        Store(a(0, 0) * scale, out(1, 1));
+      } else {
+        Lanes cofactor[3][3];
+        for (int i = 0; i < 3; i++) {
+          int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+          for (int j = 0; j < 3; j++) {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            cofactor[i][j] = a(i1, j1) * a(i2, j2) - a(i1, j2) * a(i2, j1);
+          }
+        }
+        det = a(0, 0) * cofactor[0][0] + a(0, 1) * cofactor[0][1] +
+              a(0, 2) * cofactor[0][2];
+        Lanes scale = Reciprocal(det);
+        for (int i = 0; i < 3; i++) {
+          for (int j = 0; j < 3; j++) Store(cofactor[i][j] * scale, out(j, i));
+        }
+      }
+      Store(FlagZero(det, Splat(0.0)), singular.data() + block * kLanes);
+    };
+    RunBlocks(blocks_, 4 * n * n * n, body);
+  } else {
+    // Gauss-Jordan with partial pivoting on [A | I].
+    S21MatrixBatch work(*this);
+    std::vector<double> scales(static_cast<std::size_t>(blocks_) * 2 * n *
+                               kLanes);
+    auto body = [&](int block) __attribute__((always_inline)) {
+      auto a = [&](int i, int j) { return work.Element(block, i, j); };
+      auto b = [&](int i, int j) { return inverse.Element(block, i, j); };
+      double* row_scale = scales.data() + block * 2 * n * kLanes;
+      double* col_scale = row_scale + n * kLanes;
+      Scales(n, a, row_scale, col_scale);
+      for (int i = 0; i < n; i++) Store(Splat(1.0), b(i, i));
+      Lanes flags = Splat(0.0);
+      for (int k = 0; k < n; k++) {
+        Lanes pivot = PivotRows(n, k, a);
+        for (int i = k + 1; i < n; i++) {
+          for (int j = k; j < n; j++) SwapWhere(pivot, i, a(k, j), a(i, j));
+          for (int j = 0; j < n; j++) SwapWhere(pivot, i, b(k, j), b(i, j));
+          SwapWhere(pivot, i, row_scale + k * kLanes, row_scale + i * kLanes);
+        }
+        Lanes diagonal = DropNoise(n, Load(a(k, k)), row_scale + k * kLanes,
+                                   col_scale + k * kLanes);
+        flags = FlagZero(diagonal, flags);
+        Lanes scale = Reciprocal(diagonal);
+        for (int j = k; j < n; j++) Store(Load(a(k, j)) * scale, a(k, j));
+        for (int j = 0; j < n; j++) Store(Load(b(k, j)) * scale, b(k, j));
+        for (int i = 0; i < n; i++) {
+          if (i == k) continue;
+          Lanes factor = Load(a(i, k));
+          for (int j = k; j < n; j++) {
+            Store(Load(a(i, j)) - factor * Load(a(k, j)), a(i, j));
+          }
+          for (int j = 0; j < n; j++) {
+            Store(Load(b(i, j)) - factor * Load(b(k, j)), b(i, j));
+          }
+        }
+      }
+      Store(flags, singular.data() + block * kLanes);
+    };
+    RunBlocks(blocks_, 2 * n * n * n, body);
+  }
+  if (std::find(singular.begin(), singular.begin() + count_, 1.0) !=
+      singular.begin() + count_) {
+    throw std::out_of_range("matrix determinant is 0");
+  }
+  inverse.ClearPadding();
+  return inverse;
+}
+
+void S21MatrixBatch::CheckIndex(int index, int i, int j) const {
+  if (index < 0 || index >= count_ || i < 0 || i >= rows_ || j < 0 ||
+      j >= cols_) {
+    throw std::out_of_range("Incorrect input, index is out of range\n");
+  }
+}
+
+void S21MatrixBatch::CheckSameSize(const S21MatrixBatch& other) const {
+  if (count_ != other.count_) {
+    throw std::logic_error("Batch sizes are not identical\n");
+  }
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw std::logic_error("Matrix sizes are not identical\n");
+  }
+}
+
+void S21MatrixBatch::ClearPadding() {
+  int used = count_ - (blocks_ - 1) * kLanes;
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      double* lanes = Element(blocks_ - 1, i, j);
+      std::fill(lanes + used, lanes + kLanes, 0.0);
+    }
+  }
+}
@@ -0,0 +1,80 @@
+#ifndef SRC_S21_MATRIX_BATCH_H_
+#define SRC_S21_MATRIX_BATCH_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Members per SIMD block of a batch.
+constexpr int kS21BatchLanes = 8;
+
+// count matrices of one rows x cols shape stored structure-of-arrays in
+// blocks of kS21BatchLanes members: within a block, element (i, j) of its
+// members is kS21BatchLanes contiguous doubles, and the block's elements
+// follow each other row by row. Each operation applies the same arithmetic to
+// a whole block at once, so the lane loops fill SIMD registers however small
+// the matrices are (2 x 2 to 4 x 4 transforms, say, whose own loops are too
+// short to vectorize), and blocks are spread over S21ThreadPool when the
+// batch is large enough. Keeping a block contiguous, rather than each
+// element of the whole batch, keeps the lanes an operation touches together
+// in cache.
+//
+// Members are reached with operator()(index, i, j), or copied in and out of
+// S21Matrix with Set and Get. The operations mirror S21Matrix and act on
+// every member: MulMatrix multiplies member k by member k of other.
+class S21MatrixBatch {
+ public:
+  // count zero matrices.
+  S21MatrixBatch(int count, int rows, int cols);
+  S21MatrixBatch(const S21MatrixBatch& other);
+  S21MatrixBatch(S21MatrixBatch&& other) noexcept;
+  S21MatrixBatch& operator=(const S21MatrixBatch& other);
+  S21MatrixBatch& operator=(S21MatrixBatch&& other) noexcept;
+  ~S21MatrixBatch();
+
+  int GetCount() const { return count_; }
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+
+  // Element (i, j) of member index.
+  double& operator()(int index, int i, int j);
+  double operator()(int index, int i, int j) const;
+
+  S21Matrix Get(int index) const;
+  void Set(int index, const S21ConstMatrixView& matrix);
+
+  bool EqMatrix(const S21MatrixBatch& other) const;
+  void SumMatrix(const S21MatrixBatch& other);
+  void SubMatrix(const S21MatrixBatch& other);
+  void MulNumber(double num);
+  void MulMatrix(const S21MatrixBatch& other);
+  S21MatrixBatch Transpose() const;
+  // det of every member, by cofactors up to 3 x 3 and by elimination with
+  // partial pivoting above.
+  std::vector<double> Determinant() const;
+  // Throws std::out_of_range if any member is singular.
+  S21MatrixBatch InverseMatrix() const;
+
+ private:
+  // Lanes of element (i, j) in block; the lanes of the last block past
+  // count_ are kept zeroed.
+  double* Element(int block, int i, int j) const {
+    return data_ + (static_cast<std::ptrdiff_t>(block) * rows_ * cols_ +
+                    i * cols_ + j) *
+                       kS21BatchLanes;
+  }
+  std::size_t Size() const {
+    return static_cast<std::size_t>(blocks_) * rows_ * cols_ * kS21BatchLanes;
+  }
+  void CheckIndex(int index, int i, int j) const;
+  void CheckSameSize(const S21MatrixBatch& other) const;
+  void ClearPadding();
+
+  int count_;
+  int rows_;
+  int cols_;
+  int blocks_;
+  double* data_;
+};
+
+#endif  // SRC_S21_MATRIX_BATCH_H_
@@ -0,0 +1,548 @@
+#ifndef SRC_S21_MATRIX_EXPR_H_
+#define SRC_S21_MATRIX_EXPR_H_
+
+// Lazily evaluated arithmetic on S21Matrix. a + b, a - b, alpha * a, a * b
+// and a.Transpose() build lightweight expression objects instead of
+// matrices; assigning one to an S21Matrix evaluates the whole tree in a
+// single pass into the destination without touching the operands. Products
+// are handed to S21Gemm, and alpha * A * B + beta * C (in either order of the
+// two terms) becomes a single GEMM call. Expressions hold references to the
+// matrices they were built from, so they should be evaluated before those go
+// out of scope.
+//
+// Included from s21_matrix_oop.h; do not include directly.
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_gemm.h"
+#include "s21_transpose.h"
+
+// Matrices are held by reference, every other node by value.
+template <class E>
+struct S21ExprStorage {
+  using Type = const E;
+};
+
+template <>
+struct S21ExprStorage<S21Matrix> {
+  using Type = const S21Matrix&;
+};
+
+template <class L, class R>
+class S21SumExpr : public S21MatrixExpr<S21SumExpr<L, R>> {
+ public:
+  static constexpr bool kElementwise = L::kElementwise && R::kElementwise;
+
+  S21SumExpr(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {
+    if (lhs.GetRows() != rhs.GetRows() || lhs.GetCols() != rhs.GetCols()) {
+      throw std::logic_error("Matrix sizes are not identical\n");
+    }
+  }
+  int GetRows() const { return lhs_.GetRows(); }
+  int GetCols() const { return lhs_.GetCols(); }
+  double At(int i, int j) const { return lhs_.At(i, j) + rhs_.At(i, j); }
+  void Prepare() const {
+    lhs_.Prepare();
+    rhs_.Prepare();
+  }
+  bool References(const double* begin, const double* end) const {
+    return lhs_.References(begin, end) || rhs_.References(begin, end);
+  }
+  const L& Lhs() const { return lhs_; }
+  const R& Rhs() const { return rhs_; }
+
+ private:
+  typename S21ExprStorage<L>::Type lhs_;
+  typename S21ExprStorage<R>::Type rhs_;
+};
+
+template <class L, class R>
+class S21DiffExpr : public S21MatrixExpr<S21DiffExpr<L, R>> {
+ public:
+  static constexpr bool kElementwise = L::kElementwise && R::kElementwise;
+
+  S21DiffExpr(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {
+    if (lhs.GetRows() != rhs.GetRows() || lhs.GetCols() != rhs.GetCols()) {
+      throw std::logic_error("Matrix sizes are not identical\n");
+    }
+  }
+  int GetRows() const { return lhs_.GetRows(); }
+  int GetCols() const { return lhs_.GetCols(); }
+  double At(int i, int j) const { return lhs_.At(i, j) - rhs_.At(i, j); }
+  void Prepare() const {
+    lhs_.Prepare();
+    rhs_.Prepare();
+  }
+  bool References(const double* begin, const double* end) const {
+    return lhs_.References(begin, end) || rhs_.References(begin, end);
+  }
+
+ private:
+  typename S21ExprStorage<L>::Type lhs_;
+  typename S21ExprStorage<R>::Type rhs_;
+};
+
+template <class E>
+class S21ScaleExpr : public S21MatrixExpr<S21ScaleExpr<E>> {
+ public:
+  static constexpr bool kElementwise = E::kElementwise;
+
+  S21ScaleExpr(double alpha, const E& operand)
+      : alpha_(alpha), operand_(operand) {}
+  int GetRows() const { return operand_.GetRows(); }
+  int GetCols() const { return operand_.GetCols(); }
+  double At(int i, int j) const { return alpha_ * operand_.At(i, j); }
+  void Prepare() const { operand_.Prepare(); }
+  bool References(const double* begin, const double* end) const {
+    return operand_.References(begin, end);
+  }
+  double Alpha() const { return alpha_; }
+  const E& Operand() const { return operand_; }
+
+ private:
+  double alpha_;
+  typename S21ExprStorage<E>::Type operand_;
+};
+
+template <class E>
+class S21TransposeExpr : public S21MatrixExpr<S21TransposeExpr<E>> {
+ public:
+  static constexpr bool kElementwise = false;
+
+  explicit S21TransposeExpr(const E& operand) : operand_(operand) {
+    if (operand.GetRows() == 1 && operand.GetCols() == 1) {
+      throw std::logic_error("Wrong matrix size\n");
+    }
+  }
+  int GetRows() const { return operand_.GetCols(); }
+  int GetCols() const { return operand_.GetRows(); }
+  double At(int i, int j) const { return operand_.At(j, i); }
+  void Prepare() const { operand_.Prepare(); }
+  bool References(const double* begin, const double* end) const {
+    return operand_.References(begin, end);
+  }
+  const E& Operand() const { return operand_; }
+
+ private:
+  typename S21ExprStorage<E>::Type operand_;
+};
+
+// true when evaluating e may read an element of m.
+template <class E>
+bool S21Reads(const E& e, const S21Matrix& m) {
+  const double* begin = m.Data();
+  return e.References(
+      begin, begin + static_cast<std::ptrdiff_t>(m.GetRows()) * m.Stride());
+}
+
+// Gives S21Gemm a row-major operand for e: the storage of e itself when e is
+// a matrix or a view, possibly scaled or transposed, otherwise a temporary
+// holding its value. Scales fold into alpha and transposes flip op, so
+// neither is ever materialized.
+inline S21ConstMatrixView S21GemmSource(const S21Matrix& e, double*,
+                                        S21GemmOp*,
+                                        std::unique_ptr<S21Matrix>*) {
+  return e;
+}
+
+inline S21ConstMatrixView S21GemmSource(const S21ConstMatrixView& e, double*,
+                                        S21GemmOp*,
+                                        std::unique_ptr<S21Matrix>*) {
+  return e;
+}
+
+template <class E>
+S21ConstMatrixView S21GemmSource(const S21ScaleExpr<E>& e, double* alpha,
+                                 S21GemmOp* op,
+                                 std::unique_ptr<S21Matrix>* storage) {
+  *alpha *= e.Alpha();
+  return S21GemmSource(e.Operand(), alpha, op, storage);
+}
+
+template <class E>
+S21ConstMatrixView S21GemmSource(const S21TransposeExpr<E>& e, double* alpha,
+                                 S21GemmOp* op,
+                                 std::unique_ptr<S21Matrix>* storage) {
+  *op = *op == S21GemmOp::kTrans ? S21GemmOp::kNoTrans : S21GemmOp::kTrans;
+  return S21GemmSource(e.Operand(), alpha, op, storage);
+}
+
+template <class E>
+S21ConstMatrixView S21GemmSource(const E& e, double*, S21GemmOp*,
+                                 std::unique_ptr<S21Matrix>* storage) {
+  storage->reset(new S21Matrix(e));
+  return **storage;
+}
+
+template <class L, class R>
+class S21ProductExpr : public S21MatrixExpr<S21ProductExpr<L, R>> {
+ public:
+  // At() reads a private result computed by Prepare().
+  static constexpr bool kElementwise = true;
+
+  S21ProductExpr(const L& lhs, const R& rhs) : lhs_(lhs), rhs_(rhs) {
+    if (lhs.GetCols() != rhs.GetRows()) {
+      throw std::out_of_range(
+          "the number of columns of the first matrix does not equal the "
+          "number of rows of the second matrix\n");
+    }
+  }
+  int GetRows() const { return lhs_.GetRows(); }
+  int GetCols() const { return rhs_.GetCols(); }
+  double At(int i, int j) const { return result_->At(i, j); }
+  void Prepare() const {
+    if (!result_) {
+      result_ = std::make_shared<S21Matrix>(GetRows(), GetCols());
+      GemmInto(1.0, 0.0, result_->Data(), result_->Stride());
+    }
+  }
+  bool References(const double* begin, const double* end) const {
+    return lhs_.References(begin, end) || rhs_.References(begin, end);
+  }
+  // C = alpha * lhs * rhs + beta * C for the result-shaped block C at c
+  // (leading dimension ldc), which must not be read by either operand.
+  void GemmInto(double alpha, double beta, double* c, int ldc) const {
+    std::unique_ptr<S21Matrix> lhs_storage;
+    std::unique_ptr<S21Matrix> rhs_storage;
+    S21GemmOp op_a = S21GemmOp::kNoTrans;
+    S21GemmOp op_b = S21GemmOp::kNoTrans;
+    S21ConstMatrixView a = S21GemmSource(lhs_, &alpha, &op_a, &lhs_storage);
+    S21ConstMatrixView b = S21GemmSource(rhs_, &alpha, &op_b, &rhs_storage);
+    S21Gemm(op_a, op_b, GetRows(), GetCols(), lhs_.GetCols(), alpha, a.Data(),
+            a.Stride(), b.Data(), b.Stride(), beta, c, ldc);
+  }
+
+ private:
+  typename S21ExprStorage<L>::Type lhs_;
+  typename S21ExprStorage<R>::Type rhs_;
+  mutable std::shared_ptr<S21Matrix> result_;
+};
+
+template <class E>
+S21TransposeExpr<E> S21MatrixExpr<E>::Transpose() const {
+  return S21TransposeExpr<E>(Derived());
+}
+
+template <class L, class R>
+S21SumExpr<L, R> operator+(const S21MatrixExpr<L>& lhs,
+                           const S21MatrixExpr<R>& rhs) {
+  return S21SumExpr<L, R>(lhs.Derived(), rhs.Derived());
+}
+
+template <class L, class R>
+S21DiffExpr<L, R> operator-(const S21MatrixExpr<L>& lhs,
+                            const S21MatrixExpr<R>& rhs) {
+  return S21DiffExpr<L, R>(lhs.Derived(), rhs.Derived());
+}
+
+template <class E>
+S21ScaleExpr<E> operator*(const S21MatrixExpr<E>& operand, double alpha) {
+  return S21ScaleExpr<E>(alpha, operand.Derived());
+}
+
+template <class E>
+S21ScaleExpr<E> operator*(double alpha, const S21MatrixExpr<E>& operand) {
+  return S21ScaleExpr<E>(alpha, operand.Derived());
+}
+
+template <class L, class R>
+S21ProductExpr<L, R> operator*(const S21MatrixExpr<L>& lhs,
+                               const S21MatrixExpr<R>& rhs) {
+  return S21ProductExpr<L, R>(lhs.Derived(), rhs.Derived());
+}
+
+// Compares the values of two expressions with S21Matrix::EqMatrix. A matrix
+// on the left uses the member operators.
+template <class L, class R,
+          class = std::enable_if_t<!std::is_same<L, S21Matrix>::value>>
+bool operator==(const S21MatrixExpr<L>& lhs, const S21MatrixExpr<R>& rhs) {
+  S21Matrix lhs_value(lhs);
+  return lhs_value.EqMatrix(S21Matrix(rhs));
+}
+
+template <class E>
+bool S21Matrix::operator==(const S21MatrixExpr<E>& expr) {
+  return EqMatrix(S21Matrix(expr));
+}
+
+// A temporary matrix operand is reused as the result: the operation runs in
+// place in its buffer, which is then moved out, instead of building an
+// expression over a matrix that is about to be destroyed.
+template <class R>
+S21Matrix operator+(S21Matrix&& lhs, const S21MatrixExpr<R>& rhs) {
+  lhs = lhs + rhs.Derived();
+  return std::move(lhs);
+}
+
+template <class L>
+S21Matrix operator+(const S21MatrixExpr<L>& lhs, S21Matrix&& rhs) {
+  rhs = lhs.Derived() + rhs;
+  return std::move(rhs);
+}
+
+inline S21Matrix operator+(S21Matrix&& lhs, S21Matrix&& rhs) {
+  lhs = lhs + rhs;
+  return std::move(lhs);
+}
+
+template <class R>
+S21Matrix operator-(S21Matrix&& lhs, const S21MatrixExpr<R>& rhs) {
+  lhs = lhs - rhs.Derived();
+  return std::move(lhs);
+}
+
+template <class L>
+S21Matrix operator-(const S21MatrixExpr<L>& lhs, S21Matrix&& rhs) {
+  rhs = lhs.Derived() - rhs;
+  return std::move(rhs);
+}
+
+inline S21Matrix operator-(S21Matrix&& lhs, S21Matrix&& rhs) {
+  lhs = lhs - rhs;
+  return std::move(lhs);
+}
+
+inline S21Matrix operator*(S21Matrix&& operand, double alpha) {
+  operand.MulNumber(alpha);
+  return std::move(operand);
+}
+
+inline S21Matrix operator*(double alpha, S21Matrix&& operand) {
+  operand.MulNumber(alpha);
+  return std::move(operand);
+}
+
+// Recognizes alpha * (product) and beta * (matrix) terms of a GEMM update.
+template <class E>
+struct S21ProductTerm {
+  static constexpr bool kMatch = false;
+};
+
+template <class L, class R>
+struct S21ProductTerm<S21ProductExpr<L, R>> {
+  static constexpr bool kMatch = true;
+  static double Alpha(const S21ProductExpr<L, R>&) { return 1.0; }
+  static const S21ProductExpr<L, R>& Product(const S21ProductExpr<L, R>& e) {
+    return e;
+  }
+};
+
+template <class L, class R>
+struct S21ProductTerm<S21ScaleExpr<S21ProductExpr<L, R>>> {
+  static constexpr bool kMatch = true;
+  static double Alpha(const S21ScaleExpr<S21ProductExpr<L, R>>& e) {
+    return e.Alpha();
+  }
+  static const S21ProductExpr<L, R>& Product(
+      const S21ScaleExpr<S21ProductExpr<L, R>>& e) {
+    return e.Operand();
+  }
+};
+
+template <class E>
+struct S21MatrixTerm {
+  static constexpr bool kMatch = false;
+};
+
+template <>
+struct S21MatrixTerm<S21Matrix> {
+  static constexpr bool kMatch = true;
+  static double Beta(const S21Matrix&) { return 1.0; }
+  static const S21Matrix& Matrix(const S21Matrix& e) { return e; }
+};
+
+template <>
+struct S21MatrixTerm<S21ScaleExpr<S21Matrix>> {
+  static constexpr bool kMatch = true;
+  static double Beta(const S21ScaleExpr<S21Matrix>& e) { return e.Alpha(); }
+  static const S21Matrix& Matrix(const S21ScaleExpr<S21Matrix>& e) {
+    return e.Operand();
+  }
+};
+
+// Writes the value of e into dest, resizing dest when the shapes differ.
+template <class E, class Enable = void>
+struct S21Evaluator {
+  static void Run(S21Matrix* dest, const E& e) {
+    e.Prepare();
+    int rows = e.GetRows();
+    int cols = e.GetCols();
+    bool same_shape = dest->GetRows() == rows && dest->GetCols() == cols;
+    if (S21Reads(e, *dest) && (!E::kElementwise || !same_shape)) {
+      *dest = S21Matrix(e);
+    } else {
+      if (!same_shape) {
+        *dest = S21Matrix(rows, cols);
+      }
+      double* out = dest->MutableData();
+      int stride = dest->Stride();
+      for (int i = 0; i < rows; i++, out += stride) {
+        for (int j = 0; j < cols; j++) {
+          out[j] = e.At(i, j);
+        }
+      }
+    }
+  }
+};
+
+template <class E>
+struct S21Evaluator<E, std::enable_if_t<S21ProductTerm<E>::kMatch>> {
+  static void Run(S21Matrix* dest, const E& e) {
+    const auto& product = S21ProductTerm<E>::Product(e);
+    if (S21Reads(product, *dest)) {
+      *dest = S21Matrix(e);
+    } else {
+      if (dest->GetRows() != e.GetRows() || dest->GetCols() != e.GetCols()) {
+        *dest = S21Matrix(e.GetRows(), e.GetCols());
+      }
+      product.GemmInto(S21ProductTerm<E>::Alpha(e), 0.0, dest->MutableData(),
+                       dest->Stride());
+    }
+  }
+};
+
+// Views are copied row by row.
+template <>
+struct S21Evaluator<S21ConstMatrixView> {
+  static void Run(S21Matrix* dest, const S21ConstMatrixView& e) {
+    if (S21Reads(e, *dest)) {
+      *dest = S21Matrix(e);
+    } else {
+      if (dest->GetRows() != e.GetRows() || dest->GetCols() != e.GetCols()) {
+        *dest = S21Matrix(e.GetRows(), e.GetCols());
+      }
+      double* out = dest->MutableData();
+      for (int i = 0; i < e.GetRows(); i++, out += dest->Stride()) {
+        std::copy(e.RowData(i), e.RowData(i) + e.GetCols(), out);
+      }
+    }
+  }
+};
+
+// A plain a.Transpose() goes through the blocked transpose, in place when a
+// is square and is also the destination.
+template <>
+struct S21Evaluator<S21TransposeExpr<S21Matrix>> {
+  static void Run(S21Matrix* dest, const S21TransposeExpr<S21Matrix>& e) {
+    const S21Matrix& a = e.Operand();
+    if (&a == dest && a.GetRows() == a.GetCols()) {
+      S21TransposeInPlace(a.GetRows(), dest->MutableData(), dest->Stride());
+    } else if (&a == dest) {
+      *dest = S21Matrix(e);
+    } else {
+      if (dest->GetRows() != e.GetRows() || dest->GetCols() != e.GetCols()) {
+        *dest = S21Matrix(e.GetRows(), e.GetCols());
+      }
+      S21Transpose(a.GetRows(), a.GetCols(), a.Data(), a.Stride(),
+                   dest->MutableData(), dest->Stride());
+    }
+  }
+};
+
+template <>
+struct S21Evaluator<S21TransposeExpr<S21ConstMatrixView>> {
+  static void Run(S21Matrix* dest,
+                  const S21TransposeExpr<S21ConstMatrixView>& e) {
+    const S21ConstMatrixView& a = e.Operand();
+    if (S21Reads(a, *dest)) {
+      *dest = S21Matrix(e);
+    } else {
+      if (dest->GetRows() != e.GetRows() || dest->GetCols() != e.GetCols()) {
+        *dest = S21Matrix(e.GetRows(), e.GetCols());
+      }
+      S21Transpose(a.GetRows(), a.GetCols(), a.Data(), a.Stride(),
+                   dest->MutableData(), dest->Stride());
+    }
+  }
+};
+
+// dest = alpha * A * B + beta * C as one GEMM call, in place when C is dest.
+template <class P, class M>
+void S21EvaluateGemmUpdate(S21Matrix* dest, const P& product_term,
+                           const M& matrix_term) {
+  const auto& product = S21ProductTerm<P>::Product(product_term);
+  const S21Matrix& c = S21MatrixTerm<M>::Matrix(matrix_term);
+  double beta = S21MatrixTerm<M>::Beta(matrix_term);
+  if (S21Reads(product, *dest)) {
+    *dest = S21Matrix(product_term + matrix_term);
+  } else {
+    if (&c != dest) {
+      S21Evaluator<S21ScaleExpr<S21Matrix>>::Run(
+          dest, S21ScaleExpr<S21Matrix>(beta, c));
+      beta = 1.0;
+    }
+    product.GemmInto(S21ProductTerm<P>::Alpha(product_term), beta,
+                     dest->MutableData(), dest->Stride());
+  }
+}
+
+template <class L, class R>
+struct S21Evaluator<S21SumExpr<L, R>,
+                    std::enable_if_t<S21ProductTerm<L>::kMatch &&
+                                     S21MatrixTerm<R>::kMatch>> {
+  static void Run(S21Matrix* dest, const S21SumExpr<L, R>& e) {
+    S21EvaluateGemmUpdate(dest, e.Lhs(), e.Rhs());
+  }
+};
+
+template <class L, class R>
+struct S21Evaluator<S21SumExpr<L, R>,
+                    std::enable_if_t<S21MatrixTerm<L>::kMatch &&
+                                     S21ProductTerm<R>::kMatch>> {
+  static void Run(S21Matrix* dest, const S21SumExpr<L, R>& e) {
+    S21EvaluateGemmUpdate(dest, e.Rhs(), e.Lhs());
+  }
+};
+
+template <class E>
+void S21MatrixView::Assign(const S21MatrixExpr<E>& expr) const {
+  const E& e = expr.Derived();
+  if (e.GetRows() != rows_ || e.GetCols() != cols_) {
+    throw std::logic_error("Matrix sizes are not identical\n");
+  }
+  if (e.References(data_, RowData(rows_ - 1) + cols_)) {
+    Assign(S21ConstMatrixView(S21Matrix(e)));
+  } else if constexpr (S21ProductTerm<E>::kMatch) {
+    S21ProductTerm<E>::Product(e).GemmInto(S21ProductTerm<E>::Alpha(e), 0.0,
+                                           Data(), stride_);
+  } else {
+    e.Prepare();
+    for (int i = 0; i < rows_; i++) {
+      double* out = RowData(i);
+      for (int j = 0; j < cols_; j++) {
+        out[j] = e.At(i, j);
+      }
+    }
+  }
+}
+
+// The product reads this matrix, so it is evaluated into a new buffer that
+// then replaces this one.
+template <class E>
+void S21Matrix::MulMatrix(const S21TransposeExpr<E>& other) {
+  *this = *this * other;
+}
+
+template <class E>
+S21Matrix& S21Matrix::operator*=(const S21TransposeExpr<E>& other) {
+  MulMatrix(other);
+  return *this;
+}
+
+template <class E>
+S21Matrix::BasicS21Matrix(const S21MatrixExpr<E>& expr)
+    : S21Matrix(expr.Derived().GetRows(), expr.Derived().GetCols()) {
+  S21Evaluator<E>::Run(this, expr.Derived());
+}
+
+template <class E>
+S21Matrix& S21Matrix::operator=(const S21MatrixExpr<E>& expr) {
+  S21Evaluator<E>::Run(this, expr.Derived());
+  return *this;
+}
+
+#endif  // SRC_S21_MATRIX_EXPR_H_
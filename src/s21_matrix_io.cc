@@ -0,0 +1,352 @@
+#include "s21_matrix_io.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[8] = {'S', '2', '1', 'M', 'A', 'T', 'R', 'X'};
+constexpr std::uint32_t kByteOrderMark = 0x01020304;
+constexpr std::uint32_t kFloat64 = 1;
+// Elements S21SaveMatrix writes per call.
+constexpr std::size_t kChunkElements = std::size_t{1} << 17;
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t element_type;
+  std::uint32_t data_offset;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  std::uint64_t stride;
+  std::uint64_t checksum;
+  std::uint64_t reserved;
+};
+static_assert(sizeof(FileHeader) == 64, "the header is 64 bytes");
+
+// S21MatrixChecksum fed piece by piece; every piece is a multiple of 4
+// elements.
+class Checksum {
+ public:
+  void Update(const double* data, std::size_t count) {
+    for (std::size_t i = 0; i < count; i += 4) {
+      for (int s = 0; s < 4; s++) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i + s, sizeof(word));
+        state_[s] = (state_[s] ^ word) * kPrime;
+      }
+    }
+  }
+  std::uint64_t Final() const {
+    std::uint64_t res = kBasis;
+    for (std::uint64_t stream : state_) res = (res ^ stream) * kPrime;
+    return res;
+  }
+
+ private:
+  static constexpr std::uint64_t kBasis = 14695981039346656037ull;
+  static constexpr std::uint64_t kPrime = 1099511628211ull;
+  std::uint64_t state_[4] = {kBasis, kBasis, kBasis, kBasis};
+};
+
+void SwapBytes(double* data, std::size_t count) {
+  for (std::size_t i = 0; i < count; i++) {
+    std::uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    word = __builtin_bswap64(word);
+    std::memcpy(data + i, &word, sizeof(word));
+  }
+}
+
+// Validates header against a file of file_bytes bytes, converting its fields
+// to native byte order; returns true if the elements need swapping.
+bool ReadHeader(FileHeader* header, std::uint64_t file_bytes) {
+  bool swapped = header->byte_order == __builtin_bswap32(kByteOrderMark);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+      (!swapped && header->byte_order != kByteOrderMark)) {
+    throw std::runtime_error("not a matrix file\n");
+  }
+  if (swapped) {
+    header->version = __builtin_bswap32(header->version);
+    header->element_type = __builtin_bswap32(header->element_type);
+    header->data_offset = __builtin_bswap32(header->data_offset);
+    header->rows = __builtin_bswap64(header->rows);
+    header->cols = __builtin_bswap64(header->cols);
+    header->stride = __builtin_bswap64(header->stride);
+    header->checksum = __builtin_bswap64(header->checksum);
+  }
+  if (header->version != kS21MatrixFileVersion) {
+    throw std::runtime_error("unsupported matrix file version\n");
+  }
+  if (header->element_type != kFloat64) {
+    throw std::runtime_error("unsupported matrix element type\n");
+  }
+  if (header->rows < 1 || header->cols < 1 || header->rows > INT_MAX ||
+      header->stride > INT_MAX || header->stride < header->cols ||
+      header->stride % 4 != 0 || header->data_offset < sizeof(FileHeader) ||
+      header->data_offset % sizeof(double) != 0) {
+    throw std::runtime_error("corrupted matrix file header\n");
+  }
+  if (file_bytes < header->data_offset ||
+      (file_bytes - header->data_offset) / sizeof(double) / header->stride <
+          header->rows) {
+    throw std::runtime_error("matrix file is truncated\n");
+  }
+  return swapped;
+}
+
+int StrideFor(int cols) {
+  constexpr int kLanes = S21Matrix::kLanes;
+  return (cols + kLanes - 1) / kLanes * kLanes;
+}
+
+// Header of a native-order file; the checksum is left 0.
+FileHeader NewHeader(int rows, int cols, int stride) {
+  FileHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kS21MatrixFileVersion;
+  header.byte_order = kByteOrderMark;
+  header.element_type = kFloat64;
+  header.data_offset = sizeof(FileHeader);
+  header.rows = rows;
+  header.cols = cols;
+  header.stride = stride;
+  return header;
+}
+
+}  // namespace
+
+void S21SaveMatrix(const S21ConstMatrixView& matrix, const std::string& path) {
+  int rows = matrix.GetRows();
+  int cols = matrix.GetCols();
+  int stride = StrideFor(cols);
+  FileHeader header = NewHeader(rows, cols, stride);
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  // The checksum is only known at the end, so the header is written twice.
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  // Rows are gathered into zero-padded chunks, whatever the view's stride.
+  int chunk_rows = std::max(1, static_cast<int>(kChunkElements / stride));
+  std::vector<double> chunk(static_cast<std::size_t>(chunk_rows) * stride,
+                            0.0);
+  Checksum checksum;
+  for (int i = 0; out && i < rows; i += chunk_rows) {
+    int count = std::min(chunk_rows, rows - i);
+    for (int r = 0; r < count; r++) {
+      std::copy(matrix.RowData(i + r), matrix.RowData(i + r) + cols,
+                chunk.data() + static_cast<std::size_t>(r) * stride);
+    }
+    std::size_t elements = static_cast<std::size_t>(count) * stride;
+    checksum.Update(chunk.data(), elements);
+    out.write(reinterpret_cast<const char*>(chunk.data()),
+              elements * sizeof(double));
+  }
+  header.checksum = checksum.Final();
+  out.seekp(0);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.close();
+  if (!out) {
+    throw std::runtime_error("cannot write matrix file\n");
+  }
+}
+
+std::uint64_t S21MatrixChecksum(const double* data, std::size_t count) {
+  Checksum checksum;
+  checksum.Update(data, count);
+  return checksum.Final();
+}
+
+void S21Matrix::Save(const std::string& path) const {
+  S21SaveMatrix(*this, path);
+}
+
+S21Matrix S21Matrix::Load(const std::string& path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    throw std::runtime_error("cannot open matrix file\n");
+  }
+  std::uint64_t file_bytes = static_cast<std::uint64_t>(in.tellg());
+  FileHeader header;
+  in.seekg(0);
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    throw std::runtime_error("matrix file is truncated\n");
+  }
+  bool swapped = ReadHeader(&header, file_bytes);
+  S21Matrix matrix(static_cast<int>(header.rows),
+                   static_cast<int>(header.cols));
+  Checksum checksum;
+  in.seekg(header.data_offset);
+  if (!swapped && header.stride == static_cast<std::uint64_t>(matrix.stride_)) {
+    // Same layout as in memory: one read straight into the buffer.
+    std::size_t elements =
+        static_cast<std::size_t>(matrix.rows_) * matrix.stride_;
+    in.read(reinterpret_cast<char*>(matrix.matrix_),
+            elements * sizeof(double));
+    checksum.Update(matrix.matrix_, elements);
+    for (int i = 0; i < matrix.rows_; i++) {
+      std::fill(matrix.RowData(i) + matrix.cols_,
+                matrix.RowData(i) + matrix.stride_, 0.0);
+    }
+  } else {
+    std::vector<double> row(header.stride);
+    for (int i = 0; in && i < matrix.rows_; i++) {
+      in.read(reinterpret_cast<char*>(row.data()),
+              row.size() * sizeof(double));
+      if (swapped) SwapBytes(row.data(), row.size());
+      checksum.Update(row.data(), row.size());
+      std::copy(row.begin(), row.begin() + matrix.cols_, matrix.RowData(i));
+    }
+  }
+  if (!in) {
+    throw std::runtime_error("matrix file is truncated\n");
+  }
+  if (checksum.Final() != header.checksum) {
+    throw std::runtime_error("matrix file checksum mismatch\n");
+  }
+  return matrix;
+}
+
+// ------------------------------------------------------------- mapping --
+
+S21MappedMatrix::S21MappedMatrix(const std::string& path, S21MapMode mode)
+    : base_(nullptr), length_(0), data_(nullptr), mode_(mode) {
+  int fd = open(path.c_str(),
+                mode == S21MapMode::kReadWrite ? O_RDWR : O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("cannot open matrix file\n");
+  }
+  struct stat info;
+  if (fstat(fd, &info) == 0 &&
+      static_cast<std::size_t>(info.st_size) >= sizeof(FileHeader)) {
+    length_ = static_cast<std::size_t>(info.st_size);
+    bool read_only = mode == S21MapMode::kReadOnly;
+    bool shared = mode != S21MapMode::kCopyOnWrite;
+    void* base = mmap(nullptr, length_,
+                      read_only ? PROT_READ : PROT_READ | PROT_WRITE,
+                      shared ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    base_ = base == MAP_FAILED ? nullptr : base;
+  }
+  // The mapping keeps the file open.
+  close(fd);
+  if (base_ == nullptr) {
+    throw std::runtime_error(length_ == 0 ? "matrix file is truncated\n"
+                                          : "cannot map matrix file\n");
+  }
+  FileHeader header;
+  std::memcpy(&header, base_, sizeof(header));
+  try {
+    if (ReadHeader(&header, length_)) {
+      throw std::runtime_error(
+          "matrix file byte order differs from this machine; use Load\n");
+    }
+  } catch (...) {
+    Unmap();
+    throw;
+  }
+  data_ = reinterpret_cast<double*>(static_cast<char*>(base_) +
+                                    header.data_offset);
+  rows_ = static_cast<int>(header.rows);
+  cols_ = static_cast<int>(header.cols);
+  stride_ = static_cast<int>(header.stride);
+  checksum_ = header.checksum;
+}
+
+S21MappedMatrix::S21MappedMatrix(S21MappedMatrix&& other) noexcept
+    : base_(other.base_),
+      length_(other.length_),
+      data_(other.data_),
+      mode_(other.mode_),
+      rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      checksum_(other.checksum_) {
+  other.base_ = nullptr;
+  other.data_ = nullptr;
+}
+
+S21MappedMatrix& S21MappedMatrix::operator=(S21MappedMatrix&& other) noexcept {
+  if (this != &other) {
+    Unmap();
+    base_ = other.base_;
+    length_ = other.length_;
+    data_ = other.data_;
+    mode_ = other.mode_;
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    checksum_ = other.checksum_;
+    other.base_ = nullptr;
+    other.data_ = nullptr;
+  }
+  return *this;
+}
+
+S21MappedMatrix::~S21MappedMatrix() {
+  if (base_ != nullptr && mode_ == S21MapMode::kReadWrite) Flush();
+  Unmap();
+}
+
+S21MappedMatrix S21MappedMatrix::Create(const std::string& path, int rows,
+                                        int cols) {
+  if (rows < 1 || cols < 1) {
+    throw std::logic_error("Wrong size of the Matrix");
+  }
+  int stride = StrideFor(cols);
+  FileHeader header = NewHeader(rows, cols, stride);
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  bool created =
+      fd >= 0 &&
+      write(fd, &header, sizeof(header)) ==
+          static_cast<ssize_t>(sizeof(header)) &&
+      ftruncate(fd, static_cast<off_t>(sizeof(header) +
+                                       static_cast<std::size_t>(rows) *
+                                           stride * sizeof(double))) == 0;
+  if (fd >= 0) close(fd);
+  if (!created) {
+    throw std::runtime_error("cannot write matrix file\n");
+  }
+  return S21MappedMatrix(path, S21MapMode::kReadWrite);
+}
+
+S21ConstMatrixView S21MappedMatrix::View() const {
+  return {data_, rows_, cols_, stride_};
+}
+
+S21MatrixView S21MappedMatrix::MutableView() {
+  if (mode_ == S21MapMode::kReadOnly) {
+    throw std::logic_error("The matrix file is mapped read-only\n");
+  }
+  return {data_, rows_, cols_, stride_};
+}
+
+bool S21MappedMatrix::Verify() const {
+  return S21MatrixChecksum(data_, static_cast<std::size_t>(rows_) * stride_) ==
+         checksum_;
+}
+
+void S21MappedMatrix::Flush() {
+  if (mode_ == S21MapMode::kReadWrite) {
+    checksum_ =
+        S21MatrixChecksum(data_, static_cast<std::size_t>(rows_) * stride_);
+    std::memcpy(static_cast<char*>(base_) + offsetof(FileHeader, checksum),
+                &checksum_, sizeof(checksum_));
+    msync(base_, length_, MS_SYNC);
+  }
+}
+
+void S21MappedMatrix::Unmap() {
+  if (base_ != nullptr) {
+    munmap(base_, length_);
+    base_ = nullptr;
+  }
+}
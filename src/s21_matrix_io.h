@@ -0,0 +1,91 @@
+#ifndef SRC_S21_MATRIX_IO_H_
+#define SRC_S21_MATRIX_IO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "s21_matrix_oop.h"
+
+// Binary matrix files. A file is a 64-byte header followed by the elements:
+//   offset  size  field
+//        0     8  magic "S21MATRX"
+//        8     4  format version, kS21MatrixFileVersion
+//       12     4  byte-order mark 0x01020304 as written by the producer
+//       16     4  element type, 1 = IEEE 754 double
+//       20     4  offset of the elements, 64
+//       24     8  rows
+//       32     8  cols
+//       40     8  stride: elements from one row to the next, >= cols and
+//                 a multiple of 4
+//       48     8  checksum of the element bytes, see S21MatrixChecksum
+//       56     8  reserved, 0
+// followed by rows * stride elements, row-major. S21SaveMatrix pads rows to
+// the stride S21Matrix uses with zeros, so the rows of a mapped file sit
+// exactly as in memory. Load accepts files of either byte order; mapping
+// needs the native one.
+constexpr std::uint32_t kS21MatrixFileVersion = 1;
+
+void S21SaveMatrix(const S21ConstMatrixView& matrix, const std::string& path);
+
+// 64-bit FNV-1a over the elements as the producer's 64-bit words, in four
+// interleaved streams; count must be a multiple of 4.
+std::uint64_t S21MatrixChecksum(const double* data, std::size_t count);
+
+enum class S21MapMode {
+  kReadOnly,     // shared read-only pages
+  kCopyOnWrite,  // private pages, copied on the first write to each
+  kReadWrite,    // shared writable pages; writes reach the file
+};
+
+// A matrix file mapped into memory. Opening it reads only the header, so it
+// costs the same whatever the size of the matrix; pages are faulted in as
+// the views touch them. The views are valid while the mapping lives, and
+// work anywhere a matrix view does.
+class S21MappedMatrix {
+ public:
+  explicit S21MappedMatrix(const std::string& path,
+                           S21MapMode mode = S21MapMode::kReadOnly);
+  S21MappedMatrix(S21MappedMatrix&& other) noexcept;
+  S21MappedMatrix& operator=(S21MappedMatrix&& other) noexcept;
+  S21MappedMatrix(const S21MappedMatrix&) = delete;
+  S21MappedMatrix& operator=(const S21MappedMatrix&) = delete;
+  // Flushes a kReadWrite mapping.
+  ~S21MappedMatrix();
+
+  // Creates (or truncates) path as a rows x cols zero matrix and maps it
+  // kReadWrite. The zeros are a sparse file, so this is O(1) too; the
+  // header gets its checksum on the first Flush.
+  static S21MappedMatrix Create(const std::string& path, int rows, int cols);
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  S21MapMode Mode() const { return mode_; }
+
+  S21ConstMatrixView View() const;
+  // Writable view of a kCopyOnWrite or kReadWrite mapping. Throws
+  // std::logic_error on a read-only mapping.
+  S21MatrixView MutableView();
+  S21Matrix ToMatrix() const { return S21Matrix(View()); }
+
+  // true if the mapped elements match the checksum in the header. Reads the
+  // whole matrix, so it is not done on open.
+  bool Verify() const;
+  // Stores the checksum of the current elements in the header of a
+  // kReadWrite mapping and writes the dirty pages back to the file.
+  void Flush();
+
+ private:
+  void Unmap();
+
+  void* base_;
+  std::size_t length_;
+  double* data_;
+  S21MapMode mode_;
+  int rows_;
+  int cols_;
+  int stride_;
+  std::uint64_t checksum_;
+};
+
+#endif  // SRC_S21_MATRIX_IO_H_
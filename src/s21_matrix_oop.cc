@@ -1,33 +1,111 @@
 #include "s21_matrix_oop.h"
 
-S21Matrix::S21Matrix() : S21Matrix(1, 1) {}
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_gemm.h"
+#include "s21_instrument.h"
+#include "s21_lu.h"
+#include "s21_simd.h"
+#include "s21_strassen.h"
+#include "s21_thread_pool.h"
+
+static_assert(S21Matrix::kAlignment == kS21BufferAlignment,
+              "matrix buffers come from S21AllocateBuffer");
+
+namespace {
+
+std::atomic<bool> copy_on_write(false);
+
+// Elementwise passes over more elements than this are split across the
+// thread pool. They are bound by memory bandwidth, so one band of rows per
+// thread is enough.
+constexpr std::size_t kParallelElements = std::size_t{1} << 18;
+
+// Calls body(begin, end) on bands of rows covering [0, rows).
+template <class Body>
+void ForRows(int rows, int stride, const Body& body) {
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  int threads = pool.GetThreads();
+  if (threads == 1 ||
+      static_cast<std::size_t>(rows) * stride <= kParallelElements) {
+    body(0, rows);
+  } else {
+    int tasks = std::min(rows, threads);
+    pool.ParallelFor(tasks, [&](int task) {
+      body(static_cast<int>(static_cast<long long>(rows) * task / tasks),
+           static_cast<int>(static_cast<long long>(rows) * (task + 1) / tasks));
+    });
+  }
+}
 
-S21Matrix::S21Matrix(int rows, int cols) {
+// Minors up to 2 x 2 are read in place; larger ones are copied for the LU.
+double MinorDeterminant(const S21MinorView& minor) {
+  double det = 0.0;
+  if (minor.GetRows() == 1) {
+    det = minor.At(0, 0);
+  } else if (minor.GetRows() == 2) {
+    det = minor.At(0, 0) * minor.At(1, 1) - minor.At(0, 1) * minor.At(1, 0);
+  } else {
+    det = S21Matrix(minor).Determinant();
+  }
+  return det;
+}
+
+}  // namespace
+
+void S21SetCopyOnWrite(bool enabled) {
+  copy_on_write.store(enabled, std::memory_order_relaxed);
+}
+
+bool S21GetCopyOnWrite() {
+  return copy_on_write.load(std::memory_order_relaxed);
+}
+
+S21Matrix::BasicS21Matrix() : S21Matrix(1, 1) {}
+
+S21Matrix::BasicS21Matrix(int rows, int cols)
+    : matrix_(nullptr), exposed_(false) {
   rows_ = rows;
   cols_ = cols;
   Alloc();
 }
 
-S21Matrix::S21Matrix(const S21Matrix& other)
-    : S21Matrix(other.rows_, other.cols_) {
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = other.matrix_[i][j];
-    }
+S21Matrix::BasicS21Matrix(const S21Matrix& other)
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      matrix_(other.matrix_),
+      exposed_(false) {
+  S21_INSTRUMENT_OP(S21Op::kCopy, 0);
+  if (S21GetCopyOnWrite() && matrix_ != nullptr && !other.exposed_) {
+    S21ShareBuffer(matrix_);
+  } else {
+    Alloc();
+    S21_INSTRUMENT_COPY(sizeof(double) * rows_ * stride_);
+    std::copy(other.matrix_, other.RowData(rows_), matrix_);
   }
 }
 
-S21Matrix::S21Matrix(S21Matrix&& other) {
-  if (&other != this) {
-    rows_ = other.rows_;
-    cols_ = other.cols_;
-    matrix_ = other.matrix_;
-    other.cols_ = 0;
-  }
+S21Matrix::BasicS21Matrix(S21Matrix&& other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      stride_(other.stride_),
+      matrix_(other.matrix_),
+      exposed_(other.exposed_) {
+  other.rows_ = 0;
+  other.cols_ = 0;
+  other.stride_ = 0;
+  other.matrix_ = nullptr;
+  other.exposed_ = false;
 }
 
-S21Matrix::~S21Matrix() {
-  if (cols_ != 0) {
+S21Matrix::~BasicS21Matrix() {
+  if (matrix_ != nullptr) {
     Dealloc();
   }
 }
@@ -36,53 +114,45 @@ void S21Matrix::SetRows(int rows) {
   if (rows < 0) {
     throw std::logic_error("The number of columns cannot be less than 0\n");
   }
+  S21_INSTRUMENT_OP(S21Op::kSetRows, 0);
   S21Matrix result(rows, cols_);
-  for (int i = 0; i < rows; i++) {
-    for (int j = 0; j < cols_; j++) {
-      if (i >= rows_) {
-        result.matrix_[i][j] = 0;
-      } else {
-        result.matrix_[i][j] = matrix_[i][j];
-      }
-    }
-  }
-  *this = result;
+  S21_INSTRUMENT_COPY(sizeof(double) * std::min(rows, rows_) * stride_);
+  std::copy(matrix_, RowData(std::min(rows, rows_)), result.matrix_);
+  *this = std::move(result);
 }
 
 void S21Matrix::SetCols(int cols) {
   if (cols < 0) {
     throw std::logic_error("The number of columns cannot be less than 0\n");
   }
+  S21_INSTRUMENT_OP(S21Op::kSetCols, 0);
   S21Matrix result(rows_, cols);
+  int kept = std::min(cols, cols_);
+  S21_INSTRUMENT_COPY(sizeof(double) * rows_ * kept);
   for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols; j++) {
-      if (j >= cols_) {
-        result.matrix_[i][j] = 0;
-      } else {
-        result.matrix_[i][j] = matrix_[i][j];
-      }
-    }
+    std::copy(RowData(i), RowData(i) + kept, result.RowData(i));
   }
-  *this = result;
+  *this = std::move(result);
 }
 
-int S21Matrix::GetRows() { return rows_; }
+int S21Matrix::GetRows() const { return rows_; }
 
-int S21Matrix::GetCols() { return cols_; }
+int S21Matrix::GetCols() const { return cols_; }
 
 double S21Matrix::SetMatrix(double value) {
+  Detach();
   for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = value;
-    }
+    std::fill(RowData(i), RowData(i) + cols_, value);
   }
   return value;
 }
 
 double S21Matrix::SetMatrixIncremented(double value) {
+  Detach();
   for (int i = 0; i < rows_; i++) {
+    double* row = RowData(i);
     for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] = value++;
+      row[j] = value++;
     }
   }
   return value;
@@ -92,24 +162,78 @@ void S21Matrix::Alloc() {
   if (rows_ < 1 || cols_ < 1) {
     throw std::logic_error("Wrong size of the Matrix");
   }
-  matrix_ = new double*[rows_];
-  if (matrix_ == nullptr) {
-    throw std::bad_alloc();
-  }
-  for (int i = 0; i < rows_; i++) {
-    matrix_[i] = new double[cols_]{};
-    if (matrix_[i] == nullptr) throw std::bad_alloc();
-  }
+  stride_ = (cols_ + kLanes - 1) / kLanes * kLanes;
+  std::size_t count = static_cast<std::size_t>(rows_) * stride_;
+  S21_INSTRUMENT_ALLOC(sizeof(double) * count);
+  matrix_ = S21AllocateBuffer(count);
+  std::fill(matrix_, matrix_ + count, 0.0);
 }
 
 void S21Matrix::Dealloc() {
-  for (int row = 0; row < rows_; row++) {
-    delete[] matrix_[row];
-  }
-  delete[] matrix_;
+  S21FreeBuffer(matrix_);
   matrix_ = nullptr;
 }
 
+void S21Matrix::Detach() {
+  if (S21BufferShared(matrix_)) {
+    std::size_t count = static_cast<std::size_t>(rows_) * stride_;
+    S21_INSTRUMENT_ALLOC(sizeof(double) * count);
+    S21_INSTRUMENT_COPY(sizeof(double) * count);
+    double* copy = S21AllocateBuffer(count);
+    std::copy(matrix_, matrix_ + count, copy);
+    S21FreeBuffer(matrix_);
+    matrix_ = copy;
+  }
+}
+
+const double* S21Matrix::Data() const { return matrix_; }
+
+double* S21Matrix::Data() {
+  Detach();
+  exposed_ = true;
+  return matrix_;
+}
+
+double* S21Matrix::MutableData() {
+  Detach();
+  return matrix_;
+}
+
+int S21Matrix::Stride() const { return stride_; }
+
+bool S21Matrix::References(const double* begin, const double* end) const {
+  return S21Overlaps(matrix_, RowData(rows_), begin, end);
+}
+
+S21MatrixView S21Matrix::Row(int row) { return S21MatrixView(*this).Row(row); }
+
+S21ConstMatrixView S21Matrix::Row(int row) const {
+  return S21ConstMatrixView(*this).Row(row);
+}
+
+S21MatrixView S21Matrix::Col(int col) { return S21MatrixView(*this).Col(col); }
+
+S21ConstMatrixView S21Matrix::Col(int col) const {
+  return S21ConstMatrixView(*this).Col(col);
+}
+
+S21MatrixView S21Matrix::Block(int row, int col, int rows, int cols) {
+  return S21MatrixView(*this).Block(row, col, rows, cols);
+}
+
+S21ConstMatrixView S21Matrix::Block(int row, int col, int rows,
+                                    int cols) const {
+  return S21ConstMatrixView(*this).Block(row, col, rows, cols);
+}
+
+S21MinorView S21Matrix::Minor(int row, int col) const {
+  return S21ConstMatrixView(*this).Minor(row, col);
+}
+
+double* S21Matrix::RowData(int row) const {
+  return matrix_ + static_cast<std::ptrdiff_t>(row) * stride_;
+}
+
 bool S21Matrix::EqualSize(const S21Matrix& other) {
   bool res = true;
   if ((rows_ == other.rows_) && (cols_ == other.cols_) && matrix_ != nullptr &&
@@ -124,91 +248,197 @@ bool S21Matrix::EqualSize(const S21Matrix& other) {
 
 bool S21Matrix::EqMatrix(const S21Matrix& other) {
   static const double EPS = 0.0000001;
+  S21_INSTRUMENT_OP(S21Op::kEqMatrix, 1.0 * rows_ * cols_);
   bool res = false;
   if (EqualSize(other)) {
-    res = true;
-    for (int i = 0; res != false && i < rows_; i++) {
-      for (int j = 0; res != false && j < cols_; j++) {
-        double accuracy = matrix_[i][j] - other.matrix_[i][j];
-        if (accuracy > EPS || accuracy < -EPS) {
-          res = false;
-        }
-      }
-    }
+    // Row padding is zero in both matrices, so one flat pass suffices.
+    res = S21GetKernels().equal(static_cast<std::size_t>(rows_) * stride_,
+                                matrix_, other.matrix_, EPS);
   }
   return res;
 }
 
 void S21Matrix::SumMatrix(const S21Matrix& other) {
+  S21_INSTRUMENT_OP(S21Op::kSumMatrix, 1.0 * rows_ * cols_);
   if (EqualSize(other)) {
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < cols_; j++) {
-        matrix_[i][j] += other.matrix_[i][j];
-      }
-    }
+    Detach();
+    const S21Kernels& kernels = S21GetKernels();
+    ForRows(rows_, stride_, [&](int begin, int end) {
+      kernels.add(static_cast<std::size_t>(end - begin) * stride_,
+                  other.RowData(begin), RowData(begin));
+    });
   }
 }
 
 void S21Matrix::SubMatrix(const S21Matrix& other) {
+  S21_INSTRUMENT_OP(S21Op::kSubMatrix, 1.0 * rows_ * cols_);
   if (EqualSize(other)) {
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < cols_; j++) {
-        matrix_[i][j] -= other.matrix_[i][j];
-      }
-    }
+    Detach();
+    const S21Kernels& kernels = S21GetKernels();
+    ForRows(rows_, stride_, [&](int begin, int end) {
+      kernels.sub(static_cast<std::size_t>(end - begin) * stride_,
+                  other.RowData(begin), RowData(begin));
+    });
+  }
+}
+
+bool S21Matrix::EqMatrix(const S21ConstMatrixView& other) {
+  static const double EPS = 0.0000001;
+  S21_INSTRUMENT_OP(S21Op::kEqMatrix, 1.0 * rows_ * cols_);
+  if (rows_ != other.GetRows() || cols_ != other.GetCols()) {
+    throw std::logic_error("Matrix sizes are not identical\n");
   }
+  const S21Kernels& kernels = S21GetKernels();
+  bool res = true;
+  for (int i = 0; res && i < rows_; i++) {
+    res = kernels.equal(cols_, RowData(i), other.RowData(i), EPS);
+  }
+  return res;
+}
+
+void S21Matrix::SumMatrix(const S21ConstMatrixView& other) {
+  S21_INSTRUMENT_OP(S21Op::kSumMatrix, 1.0 * rows_ * cols_);
+  S21MatrixView(MutableData(), rows_, cols_, stride_) += other;
+}
+
+void S21Matrix::SubMatrix(const S21ConstMatrixView& other) {
+  S21_INSTRUMENT_OP(S21Op::kSubMatrix, 1.0 * rows_ * cols_);
+  S21MatrixView(MutableData(), rows_, cols_, stride_) -= other;
 }
 
 void S21Matrix::MulNumber(const double num) {
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] *= num;
+  S21_INSTRUMENT_OP(S21Op::kMulNumber, 1.0 * rows_ * cols_);
+  Detach();
+  // Row by row so that an infinite num never turns the padding into NaN.
+  const S21Kernels& kernels = S21GetKernels();
+  ForRows(rows_, stride_, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      kernels.scale(cols_, num, RowData(i));
     }
+  });
+}
+
+void S21Matrix::Axpy(double alpha, const S21Matrix& x) {
+  S21_INSTRUMENT_OP(S21Op::kAxpy, 2.0 * rows_ * cols_);
+  if (EqualSize(x)) {
+    Detach();
+    // Row by row, like MulNumber.
+    const S21Kernels& kernels = S21GetKernels();
+    ForRows(rows_, stride_, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        kernels.axpby(cols_, alpha, x.RowData(i), 1.0, RowData(i));
+      }
+    });
   }
 }
 
-void S21Matrix::MulMatrix(const S21Matrix& other) {
-  if (cols_ != other.rows_) {
-    throw std::out_of_range(
-        "the number of columns of the first matrix does not equal the number "
-        "of rows of the second matrix\n");
+void S21Matrix::Axpby(double alpha, const S21Matrix& x, double beta) {
+  S21_INSTRUMENT_OP(S21Op::kAxpby, 3.0 * rows_ * cols_);
+  if (EqualSize(x)) {
+    Detach();
+    // A zero beta must drop NaNs in y, so y = alpha * x is computed as a
+    // copy of each row scaled while it is still in cache; x may be *this.
+    const S21Kernels& kernels = S21GetKernels();
+    ForRows(rows_, stride_, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        double* row = RowData(i);
+        if (beta != 0.0) {
+          kernels.axpby(cols_, alpha, x.RowData(i), beta, row);
+        } else {
+          if (x.RowData(i) != row) {
+            std::copy(x.RowData(i), x.RowData(i) + cols_, row);
+          }
+          kernels.scale(cols_, alpha, row);
+        }
+      }
+    });
+  }
+}
+
+void S21Matrix::FusedMulAdd(const S21Matrix& x, const S21Matrix& y) {
+  S21_INSTRUMENT_OP(S21Op::kFusedMulAdd, 2.0 * rows_ * cols_);
+  if (EqualSize(x) && EqualSize(y)) {
+    Detach();
+    const S21Kernels& kernels = S21GetKernels();
+    ForRows(rows_, stride_, [&](int begin, int end) {
+      kernels.mul_add(static_cast<std::size_t>(end - begin) * stride_,
+                      x.RowData(begin), y.RowData(begin), RowData(begin));
+    });
   }
-  S21Matrix tmp(rows_, other.cols_);
-  for (int i = 0; i < tmp.rows_; i++) {
-    for (int j = 0; j < tmp.cols_; j++) {
-      tmp.matrix_[i][j] = 0.0;
-      for (int k = 0; k < cols_; k++) {
-        tmp.matrix_[i][j] += matrix_[i][k] * other.matrix_[k][j];
+}
+
+void S21Matrix::HadamardProduct(const S21Matrix& other) {
+  S21_INSTRUMENT_OP(S21Op::kHadamardProduct, 1.0 * rows_ * cols_);
+  if (EqualSize(other)) {
+    Detach();
+    const S21Kernels& kernels = S21GetKernels();
+    ForRows(rows_, stride_, [&](int begin, int end) {
+      kernels.mul(static_cast<std::size_t>(end - begin) * stride_,
+                  other.RowData(begin), RowData(begin));
+    });
+  }
+}
+
+void S21Matrix::HadamardDivide(const S21Matrix& other) {
+  S21_INSTRUMENT_OP(S21Op::kHadamardDivide, 1.0 * rows_ * cols_);
+  if (EqualSize(other)) {
+    Detach();
+    // Row by row: the padding would divide 0 by 0.
+    const S21Kernels& kernels = S21GetKernels();
+    ForRows(rows_, stride_, [&](int begin, int end) {
+      for (int i = begin; i < end; i++) {
+        kernels.div(cols_, other.RowData(i), RowData(i));
       }
-    }
+    });
   }
-  *this = tmp;
 }
 
-S21Matrix S21Matrix::Transpose() {
-  S21Matrix transposedMatrix(rows_, cols_);
-  if ((transposedMatrix.rows_ <= 0) || (transposedMatrix.cols_ <= 0) ||
-      (transposedMatrix.rows_ == 1 && transposedMatrix.cols_ == 1)) {
-    throw std::logic_error("Wrong matrix size\n");
+void S21Matrix::MulMatrix(const S21Matrix& other, S21MulAlgorithm algorithm) {
+  MulMatrix(S21ConstMatrixView(other), algorithm);
+}
+
+void S21Matrix::MulMatrix(const S21ConstMatrixView& other,
+                          S21MulAlgorithm algorithm) {
+  S21_INSTRUMENT_OP(S21Op::kMulMatrix,
+                    2.0 * rows_ * cols_ * other.GetCols());
+  if (cols_ != other.GetRows()) {
+    throw std::out_of_range(
+        "the number of columns of the first matrix does not equal the number "
+        "of rows of the second matrix\n");
   }
-  for (int i = 0; i < transposedMatrix.rows_; i++) {
-    for (int j = 0; j < transposedMatrix.cols_; j++) {
-      transposedMatrix.matrix_[i][j] = matrix_[j][i];
-    }
+  S21Matrix tmp(rows_, other.GetCols());
+  if (algorithm == S21MulAlgorithm::kStrassen) {
+    S21StrassenGemm(rows_, other.GetCols(), cols_, matrix_, stride_,
+                    other.Data(), other.Stride(), tmp.matrix_, tmp.stride_);
+  } else {
+    S21Gemm(rows_, other.GetCols(), cols_, 1.0, matrix_, stride_,
+            other.Data(), other.Stride(), 0.0, tmp.matrix_, tmp.stride_);
   }
-  return transposedMatrix;
+  *this = std::move(tmp);
 }
 
 S21Matrix S21Matrix::CalcComplements() {
-  S21Matrix result = *this;
+  S21_INSTRUMENT_OP(S21Op::kCalcComplements, 2.0 * rows_ * rows_ * rows_);
+  // Every element is overwritten below.
+  S21Matrix result(rows_, cols_);
   if (SquareMatrix(*this)) {
+    S21Matrix inverse(rows_, cols_);
+    double det = 0.0;
     if (cols_ == 1) {
-      result.matrix_[0][0] = 1.0;
+      result.matrix_[0] = 1.0;
+    } else if (cols_ > 3 && Invert(&inverse, &det)) {
+      // adj(A) = det(A) * A^-1, so the complements are its transpose.
+      for (int i = 0; i < rows_; i++) {
+        double* row = result.RowData(i);
+        for (int j = 0; j < cols_; j++) {
+          row[j] = det * inverse.RowData(j)[i];
+        }
+      }
     } else {
       for (int i = 0; i < rows_; i++) {
         for (int j = 0; j < cols_; j++) {
-          S21Matrix tmpMatrix = MinorMatrix(i, j);
-          result.matrix_[i][j] = tmpMatrix.Determinant() * Pow(-1, i + j + 2);
+          result.RowData(i)[j] =
+              MinorDeterminant(Minor(i, j)) * Pow(-1, i + j + 2);
         }
       }
     }
@@ -217,48 +447,63 @@ S21Matrix S21Matrix::CalcComplements() {
 }
 
 double S21Matrix::Determinant() {
+  S21_INSTRUMENT_OP(S21Op::kDeterminant, 2.0 / 3.0 * rows_ * rows_ * rows_);
   double determ = 0.0;
   if (SquareMatrix(*this)) {
     if (cols_ == 2) {
-      determ = matrix_[0][0] * matrix_[1][1] - matrix_[0][1] * matrix_[1][0];
+      const double* top = RowData(0);
+      const double* bottom = RowData(1);
+      determ = top[0] * bottom[1] - top[1] * bottom[0];
     } else if (cols_ == 1) {
-      determ = matrix_[0][0];
-    } else if (cols_ > 2) {
-      int degree = -1;
-      for (int i = 0; i < rows_; i++) {
-        degree = -1 * degree;
-        S21Matrix tmpMatrix = MinorMatrix(i, 0);
-        determ += degree * matrix_[i][0] * tmpMatrix.Determinant();
+      determ = matrix_[0];
+    } else if (cols_ == 3) {
+      // Cofactor expansion is cheaper than a factorization up to 3 x 3 and
+      // exact for integer entries.
+      const double* r0 = RowData(0);
+      const double* r1 = RowData(1);
+      const double* r2 = RowData(2);
+      determ = r0[0] * (r1[1] * r2[2] - r1[2] * r2[1]) -
+               r0[1] * (r1[0] * r2[2] - r1[2] * r2[0]) +
+               r0[2] * (r1[0] * r2[1] - r1[1] * r2[0]);
+    } else if (cols_ > 3) {
+      S21Matrix lu(*this);
+      std::vector<int> piv(rows_);
+      determ = S21LuFactor(rows_, lu.MutableData(), lu.stride_, piv.data());
+      for (int i = 0; determ != 0.0 && i < rows_; i++) {
+        determ *= lu.RowData(i)[i];
       }
     }
   }
   return determ;
 }
 
-S21Matrix S21Matrix::MinorMatrix(int Row, int Col) {
-  S21Matrix slicedMatrix(rows_ - 1, cols_ - 1);
-  int offsetRow = 0;
-  for (int i = 0; i < slicedMatrix.rows_; i++) {
-    if (i == Row) {
-      offsetRow = 1;
-    }
-    int offsetCol = 0;
-    for (int j = 0; j < slicedMatrix.cols_; j++) {
-      if (j == Col) {
-        offsetCol = 1;
-      }
-      slicedMatrix.matrix_[i][j] = matrix_[i + offsetRow][j + offsetCol];
-    }
+S21Matrix S21Matrix::InverseMatrix() {
+  S21_INSTRUMENT_OP(S21Op::kInverseMatrix, 2.0 * rows_ * rows_ * rows_);
+  S21Matrix inverse(rows_, cols_);
+  double det = 0.0;
+  // Up to 3 x 3 Determinant expands cofactors, exact for integer entries,
+  // so the inverse agrees with it rather than with the factorization alone.
+  if (SquareMatrix(*this) &&
+      ((cols_ <= 3 && Determinant() == 0.0) || !Invert(&inverse, &det))) {
+    throw std::out_of_range("matrix determinant is 0");
   }
-  return slicedMatrix;
+  return inverse;
 }
 
-S21Matrix S21Matrix::InverseMatrix() {
-  double det = Determinant();
-  if (det == 0.0) {
-    throw std::out_of_range("matrix determinant is 0");
+bool S21Matrix::Invert(S21Matrix* inverse, double* det) {
+  S21Matrix lu(*this);
+  std::vector<int> piv(rows_);
+  int sign = S21LuFactor(rows_, lu.MutableData(), lu.stride_, piv.data());
+  *det = sign;
+  for (int i = 0; sign != 0 && i < rows_; i++) {
+    *det *= lu.RowData(i)[i];
+    inverse->RowData(i)[i] = 1.0;
+  }
+  if (sign != 0) {
+    S21LuSolve(rows_, lu.matrix_, lu.stride_, piv.data(), cols_,
+               inverse->matrix_, inverse->stride_);
   }
-  return CalcComplements().Transpose() * (1 / Determinant());
+  return sign != 0;
 }
 
 bool S21Matrix::SquareMatrix(const S21Matrix& other) {
@@ -286,18 +531,52 @@ double S21Matrix::Pow(double base, long int exp) {
   return res;
 }
 
-S21Matrix& S21Matrix::operator=(const S21Matrix& other) {  //&& (2operator=)
-  if (matrix_ != nullptr) {
-    Dealloc();
+S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
+  S21_INSTRUMENT_OP(S21Op::kCopyAssign, 0);
+  if (this != &other && S21GetCopyOnWrite() && other.matrix_ != nullptr &&
+      !other.exposed_) {
+    S21ShareBuffer(other.matrix_);
+    if (matrix_ != nullptr) {
+      Dealloc();
+    }
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    matrix_ = other.matrix_;
+    exposed_ = false;
+  } else if (this != &other) {
+    // A shared buffer is left to its other owners rather than overwritten.
+    if (rows_ != other.rows_ || cols_ != other.cols_ ||
+        S21BufferShared(matrix_)) {
+      if (matrix_ != nullptr) {
+        Dealloc();
+      }
+      this->rows_ = other.rows_;
+      this->cols_ = other.cols_;
+      Alloc();
+      exposed_ = false;
+    }
+    S21_INSTRUMENT_COPY(sizeof(double) * rows_ * stride_);
+    std::copy(other.matrix_, other.RowData(rows_), matrix_);
   }
-  this->rows_ = other.rows_;
-  this->cols_ = other.cols_;
+  return *this;
+}
 
-  Alloc();
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] = other.matrix_[i][j];
+S21Matrix& S21Matrix::operator=(S21Matrix&& other) noexcept {
+  if (this != &other) {
+    if (matrix_ != nullptr) {
+      Dealloc();
     }
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    stride_ = other.stride_;
+    matrix_ = other.matrix_;
+    exposed_ = other.exposed_;
+    other.rows_ = 0;
+    other.cols_ = 0;
+    other.stride_ = 0;
+    other.matrix_ = nullptr;
+    other.exposed_ = false;
   }
   return *this;
 }
@@ -305,10 +584,18 @@ S21Matrix& S21Matrix::operator=(const S21Matrix& other) {  //&& (2operator=)
 bool S21Matrix::operator==(const S21Matrix other) { return EqMatrix(other); }
 
 double& S21Matrix::operator()(int i, int j) {
-  if ((i < 0 || i > rows_) || (j < 0 || j > cols_)) {
+  if ((i < 0 || i >= rows_) || (j < 0 || j >= cols_)) {
+    throw std::out_of_range("Incorrect input, index is out of range\n");
+  }
+  Detach();
+  return RowData(i)[j];
+}
+
+const double& S21Matrix::operator()(int i, int j) const {
+  if ((i < 0 || i >= rows_) || (j < 0 || j >= cols_)) {
     throw std::out_of_range("Incorrect input, index is out of range\n");
   }
-  return matrix_[i][j];
+  return RowData(i)[j];
 }
 
 S21Matrix& S21Matrix::operator+=(const S21Matrix& other) {
@@ -321,36 +608,27 @@ S21Matrix& S21Matrix::operator-=(const S21Matrix& other) {
   return *this;
 }
 
-S21Matrix S21Matrix::operator+(const S21Matrix& other) {
-  SumMatrix(other);
-  S21Matrix res = *this;
-  return res;
-}
-
-S21Matrix S21Matrix::operator-(const S21Matrix& other) {
-  SubMatrix(other);
-  S21Matrix res = *this;
-  return res;
+S21Matrix& S21Matrix::operator*=(const S21Matrix& other) {
+  MulMatrix(other);
+  return *this;
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix& other) {
-  S21Matrix result(*this);
-  result.MulMatrix(other);
-  return result;
+S21Matrix& S21Matrix::operator*=(const double num) {
+  MulNumber(num);
+  return *this;
 }
 
-S21Matrix S21Matrix::operator*(const double num) {
-  MulNumber(num);
-  S21Matrix result = *this;
-  return result;
+S21Matrix& S21Matrix::operator+=(const S21ConstMatrixView& other) {
+  SumMatrix(other);
+  return *this;
 }
 
-S21Matrix& S21Matrix::operator*=(const S21Matrix& other) {
-  MulMatrix(other);
+S21Matrix& S21Matrix::operator-=(const S21ConstMatrixView& other) {
+  SubMatrix(other);
   return *this;
 }
 
-S21Matrix& S21Matrix::operator*=(const double num) {
-  MulNumber(num);
+S21Matrix& S21Matrix::operator*=(const S21ConstMatrixView& other) {
+  MulMatrix(other);
   return *this;
 }
@@ -1,56 +1,200 @@
 #ifndef SRC_S21_MATRIX_OOP_H_
 #define SRC_S21_MATRIX_OOP_H_
 
+#include <cstddef>
 #include <ostream>
+#include <string>
 
-class S21Matrix {
+template <class E>
+class S21TransposeExpr;
+class S21ConstMatrixView;
+class S21MatrixView;
+class S21MinorView;
+template <class E, class Enable>
+struct S21Evaluator;
+
+// Dense matrix of T. The primary template, for float, long double and
+// std::complex<float> / std::complex<double>, lives in s21_basic_matrix.h;
+// double is the specialization below, which everything else in the library
+// is built on, and S21Matrix names it.
+template <class T>
+class BasicS21Matrix;
+using S21Matrix = BasicS21Matrix<double>;
+
+// How MulMatrix computes a product. kStrassen recurses with the
+// Strassen-Winograd scheme above kS21StrassenCutoff and is only normwise
+// accurate; see s21_strassen.h for its error bound.
+enum class S21MulAlgorithm { kBlocked, kStrassen };
+
+// Copy-on-write storage. While it is enabled, copying an S21Matrix shares
+// the buffer instead of copying it, and the first write through either
+// matrix (operator(), Data(), a view, SumMatrix and the other mutators)
+// gives that matrix a private copy. Reads through a const matrix, At() or
+// a const view never copy. Once Data() or a mutable view has handed out a
+// pointer, the matrix is copied eagerly for the rest of its buffer's life,
+// so writes through that pointer never reach a copy. A reference returned
+// by operator() is only good until the matrix is next copied.
+//
+// Off by default. Latency-critical code can keep it off, so that copies
+// are paid up front and no write ever has to clone a buffer. The setting
+// is process-wide and only affects later copies.
+void S21SetCopyOnWrite(bool enabled);
+bool S21GetCopyOnWrite();
+
+// Base of every lazily evaluated matrix expression, S21Matrix included; E is
+// the concrete expression type. An expression E provides GetRows(),
+// GetCols(), At(i, j), Prepare() (run once before the first At),
+// References(begin, end) (true if it may read an element of [begin, end))
+// and kElementwise (true if result (i, j) only reads operand elements (i, j)
+// whenever it reads the destination).
+// s21_matrix_expr.h holds the nodes and the operators that build them.
+template <class E>
+class S21MatrixExpr {
  public:
-  S21Matrix();
-  S21Matrix(int rows, int cols);
-  S21Matrix(const S21Matrix& other);
-  S21Matrix(S21Matrix&& other);
-  ~S21Matrix();
-
-  int GetRows();
-  int GetCols();
+  const E& Derived() const { return static_cast<const E&>(*this); }
+  S21TransposeExpr<E> Transpose() const;
+};
+
+template <>
+class BasicS21Matrix<double> : public S21MatrixExpr<BasicS21Matrix<double>> {
+ public:
+  using value_type = double;
+
+  BasicS21Matrix();
+  BasicS21Matrix(int rows, int cols);
+  BasicS21Matrix(const S21Matrix& other);
+  BasicS21Matrix(S21Matrix&& other) noexcept;
+  // Evaluates expr in one fused pass, see s21_matrix_expr.h.
+  template <class E>
+  BasicS21Matrix(const S21MatrixExpr<E>& expr);
+  ~BasicS21Matrix();
+
+  int GetRows() const;
+  int GetCols() const;
   void SetRows(int rows);
   void SetCols(int cols);
   double SetMatrix(double value);
   double SetMatrixIncremented(double value);
 
   bool EqMatrix(const S21Matrix& other);
+  bool EqMatrix(const S21ConstMatrixView& other);
   void SumMatrix(const S21Matrix& other);
+  void SumMatrix(const S21ConstMatrixView& other);
   void SubMatrix(const S21Matrix& other);
+  void SubMatrix(const S21ConstMatrixView& other);
   void MulNumber(const double num);
-  void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose();
+  void MulMatrix(const S21Matrix& other,
+                 S21MulAlgorithm algorithm = S21MulAlgorithm::kBlocked);
+  void MulMatrix(const S21ConstMatrixView& other,
+                 S21MulAlgorithm algorithm = S21MulAlgorithm::kBlocked);
+  // Multiplies by other.Transpose() without materializing the transpose.
+  template <class E>
+  void MulMatrix(const S21TransposeExpr<E>& other);
+  // Fused elementwise updates, one vectorized pass each: this += alpha * x,
+  // this = alpha * x + beta * this (beta = 0 ignores the old contents, NaNs
+  // included), this += x .* y, this .*= other and this ./= other. Sizes must
+  // match. Large matrices are split into bands of rows across the thread
+  // pool.
+  void Axpy(double alpha, const S21Matrix& x);
+  void Axpby(double alpha, const S21Matrix& x, double beta);
+  void FusedMulAdd(const S21Matrix& x, const S21Matrix& y);
+  void HadamardProduct(const S21Matrix& other);
+  void HadamardDivide(const S21Matrix& other);
   S21Matrix CalcComplements();
   double Determinant();
   S21Matrix InverseMatrix();
 
+  // Binary files in the format described in s21_matrix_io.h. Load throws
+  // std::runtime_error for a missing, truncated or corrupted file.
+  void Save(const std::string& path) const;
+  static S21Matrix Load(const std::string& path);
+
   S21Matrix& operator=(const S21Matrix& other);
+  S21Matrix& operator=(S21Matrix&& other) noexcept;
+  template <class E>
+  S21Matrix& operator=(const S21MatrixExpr<E>& expr);
   bool operator==(const S21Matrix other);
+  template <class E>
+  bool operator==(const S21MatrixExpr<E>& expr);
   double& operator()(int i, int j);
+  const double& operator()(int i, int j) const;
   S21Matrix& operator+=(const S21Matrix& other);
   S21Matrix& operator-=(const S21Matrix& other);
-  S21Matrix operator+(const S21Matrix& other);
-  S21Matrix operator-(const S21Matrix& other);
   S21Matrix& operator*=(const S21Matrix& other);
   S21Matrix& operator*=(const double num);
-  S21Matrix operator*(const S21Matrix& other);
-  S21Matrix operator*(const double num);
+  S21Matrix& operator+=(const S21ConstMatrixView& other);
+  S21Matrix& operator-=(const S21ConstMatrixView& other);
+  S21Matrix& operator*=(const S21ConstMatrixView& other);
+  template <class E>
+  S21Matrix& operator*=(const S21TransposeExpr<E>& other);
+
+  // Zero-copy windows into this matrix, see s21_matrix_view.h. They are
+  // invalidated by anything that reallocates the matrix.
+  S21MatrixView Row(int row);
+  S21ConstMatrixView Row(int row) const;
+  S21MatrixView Col(int col);
+  S21ConstMatrixView Col(int col) const;
+  S21MatrixView Block(int row, int col, int rows, int cols);
+  S21ConstMatrixView Block(int row, int col, int rows, int cols) const;
+  S21MinorView Minor(int row, int col) const;
+
+  // Storage is a single row-major buffer aligned to kAlignment bytes. Each row
+  // starts stride_ elements after the previous one; stride_ is cols_ rounded
+  // up to a whole number of SIMD lanes and the padding is kept zeroed.
+  static constexpr std::size_t kAlignment = 64;
+  static constexpr int kLanes = kAlignment / sizeof(double);
+  const double* Data() const;
+  double* Data();
+  int Stride() const;
+
+  // Expression interface. At() does no bounds checking.
+  static constexpr bool kElementwise = true;
+  double At(int i, int j) const {
+    return matrix_[static_cast<std::ptrdiff_t>(i) * stride_ + j];
+  }
+  void Prepare() const {}
+  bool References(const double* begin, const double* end) const;
 
  private:
+  friend class S21LU;
+  friend class S21Cholesky;
+  friend class S21QR;
+  friend class S21MixedLU;
+  friend class S21SparseMatrix;
+  friend class S21MatrixBatch;
+  template <class E, class Enable>
+  friend struct S21Evaluator;
+  template <class P, class M>
+  friend void S21EvaluateGemmUpdate(S21Matrix* dest, const P& product_term,
+                                    const M& matrix_term);
+
   int rows_;
   int cols_;
-  double** matrix_;
+  int stride_;
+  double* matrix_;
+  // Set once Data() or a mutable view has exposed matrix_; copies of an
+  // exposed buffer are never shared.
+  bool exposed_;
 
   void Alloc();
   void Dealloc();
+  // Gives this matrix a private buffer if it shares one; writers call it
+  // first.
+  void Detach();
+  // Data() for the library's own writers, whose pointers do not outlive the
+  // call: detaches without marking the buffer exposed, so results they fill
+  // in can still be shared.
+  double* MutableData();
+  double* RowData(int row) const;
   bool EqualSize(const S21Matrix& other);
   bool SquareMatrix(const S21Matrix& other);
-  S21Matrix MinorMatrix(int row, int column);
+  // Writes A^-1 into inverse (an identity-sized matrix of zeros) and det(A)
+  // into det through an LU factorization; false if A is singular.
+  bool Invert(S21Matrix* inverse, double* det);
   static double Pow(double base, long int exp);
 };
 
+#include "s21_matrix_view.h"
+#include "s21_matrix_expr.h"
+
 #endif  // SRC_S21_MATRIX_OOP_H_
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "s21_matrix_oop.h"
+#include "s21_simd.h"
+
+namespace {
+
+void CheckSameSize(const S21ConstMatrixView& a, const S21ConstMatrixView& b) {
+  if (a.GetRows() != b.GetRows() || a.GetCols() != b.GetCols()) {
+    throw std::logic_error("Matrix sizes are not identical\n");
+  }
+}
+
+// Applies y_row = kernel(x_row, y_row) to every row. When x overlaps y at a
+// different position it is copied first, so no row reads an updated one.
+template <class Kernel>
+void RowWise(const S21MatrixView& y, const S21ConstMatrixView& x,
+             Kernel kernel) {
+  CheckSameSize(y, x);
+  bool same = x.Data() == y.Data() && x.Stride() == y.Stride();
+  if (!same && x.References(y.Data(), y.RowData(y.GetRows() - 1) +
+                                          y.GetCols())) {
+    S21Matrix copy(x);
+    RowWise(y, copy, kernel);
+  } else {
+    for (int i = 0; i < y.GetRows(); i++) {
+      kernel(y.GetCols(), x.RowData(i), y.RowData(i));
+    }
+  }
+}
+
+}  // namespace
+
+void S21MatrixView::Fill(double value) const {
+  for (int i = 0; i < rows_; i++) {
+    std::fill(RowData(i), RowData(i) + cols_, value);
+  }
+}
+
+const S21MatrixView& S21MatrixView::operator+=(
+    const S21ConstMatrixView& other) const {
+  RowWise(*this, other, S21GetKernels().add);
+  return *this;
+}
+
+const S21MatrixView& S21MatrixView::operator-=(
+    const S21ConstMatrixView& other) const {
+  RowWise(*this, other, S21GetKernels().sub);
+  return *this;
+}
+
+const S21MatrixView& S21MatrixView::operator*=(double num) const {
+  const S21Kernels& kernels = S21GetKernels();
+  for (int i = 0; i < rows_; i++) {
+    kernels.scale(cols_, num, RowData(i));
+  }
+  return *this;
+}
@@ -0,0 +1,158 @@
+#ifndef SRC_S21_MATRIX_VIEW_H_
+#define SRC_S21_MATRIX_VIEW_H_
+
+// Non-owning windows into row-major storage: a pointer to element (0, 0),
+// the shape and the distance in elements between consecutive rows. Views
+// are cheap to copy and are expressions, so they mix freely with S21Matrix
+// in arithmetic; they must not outlive the storage they point into.
+//
+// Included from s21_matrix_oop.h; do not include directly.
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+
+class S21MinorView;
+
+// true when [begin1, end1) and [begin2, end2) share an element.
+inline bool S21Overlaps(const double* begin1, const double* end1,
+                        const double* begin2, const double* end2) {
+  std::less<const double*> less;
+  return less(begin1, end2) && less(begin2, end1);
+}
+
+class S21ConstMatrixView : public S21MatrixExpr<S21ConstMatrixView> {
+ public:
+  S21ConstMatrixView(const double* data, int rows, int cols, int stride)
+      : data_(data), rows_(rows), cols_(cols), stride_(stride) {
+    if (rows < 1 || cols < 1 || stride < cols) {
+      throw std::logic_error("Wrong size of the Matrix");
+    }
+  }
+  S21ConstMatrixView(const S21Matrix& matrix)
+      : S21ConstMatrixView(matrix.Data(), matrix.GetRows(), matrix.GetCols(),
+                           matrix.Stride()) {}
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  int Stride() const { return stride_; }
+  const double* Data() const { return data_; }
+  const double* RowData(int row) const {
+    return data_ + static_cast<std::ptrdiff_t>(row) * stride_;
+  }
+  double operator()(int i, int j) const {
+    CheckIndex(i, j);
+    return At(i, j);
+  }
+
+  S21ConstMatrixView Row(int row) const { return Block(row, 0, 1, cols_); }
+  S21ConstMatrixView Col(int col) const { return Block(0, col, rows_, 1); }
+  // The rows x cols block whose top-left element is (row, col).
+  S21ConstMatrixView Block(int row, int col, int rows, int cols) const {
+    CheckBlock(row, col, rows, cols);
+    return S21ConstMatrixView(RowData(row) + col, rows, cols, stride_);
+  }
+  S21MinorView Minor(int row, int col) const;
+
+  // Expression interface. A view may overlap the destination at a different
+  // offset, so it is never evaluated in place.
+  static constexpr bool kElementwise = false;
+  double At(int i, int j) const { return RowData(i)[j]; }
+  void Prepare() const {}
+  bool References(const double* begin, const double* end) const {
+    return S21Overlaps(data_, RowData(rows_ - 1) + cols_, begin, end);
+  }
+
+ protected:
+  void CheckIndex(int i, int j) const {
+    if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
+      throw std::out_of_range("Incorrect input, index is out of range\n");
+    }
+  }
+  void CheckBlock(int row, int col, int rows, int cols) const {
+    if (row < 0 || col < 0 || rows < 1 || cols < 1 || row + rows > rows_ ||
+        col + cols > cols_) {
+      throw std::out_of_range("Incorrect input, index is out of range\n");
+    }
+  }
+
+  const double* data_;
+  int rows_;
+  int cols_;
+  int stride_;
+};
+
+// A view that can also write through to the storage.
+class S21MatrixView : public S21ConstMatrixView {
+ public:
+  S21MatrixView(double* data, int rows, int cols, int stride)
+      : S21ConstMatrixView(data, rows, cols, stride) {}
+  S21MatrixView(S21Matrix& matrix)
+      : S21ConstMatrixView(matrix.Data(), matrix.GetRows(), matrix.GetCols(),
+                           matrix.Stride()) {}
+
+  double* Data() const { return const_cast<double*>(data_); }
+  double* RowData(int row) const {
+    return Data() + static_cast<std::ptrdiff_t>(row) * stride_;
+  }
+  double& operator()(int i, int j) const {
+    CheckIndex(i, j);
+    return RowData(i)[j];
+  }
+
+  S21MatrixView Row(int row) const { return Block(row, 0, 1, cols_); }
+  S21MatrixView Col(int col) const { return Block(0, col, rows_, 1); }
+  S21MatrixView Block(int row, int col, int rows, int cols) const {
+    CheckBlock(row, col, rows, cols);
+    return S21MatrixView(RowData(row) + col, rows, cols, stride_);
+  }
+
+  // Overwrites the viewed elements with the value of expr, which must have
+  // the shape of the view. Products are computed by S21Gemm straight into
+  // the storage.
+  template <class E>
+  void Assign(const S21MatrixExpr<E>& expr) const;
+  void Fill(double value) const;
+  const S21MatrixView& operator+=(const S21ConstMatrixView& other) const;
+  const S21MatrixView& operator-=(const S21ConstMatrixView& other) const;
+  const S21MatrixView& operator*=(double num) const;
+};
+
+// The matrix without one row and one column, as read by cofactor
+// expansion. Read-only; the indices are remapped on every access.
+class S21MinorView : public S21MatrixExpr<S21MinorView> {
+ public:
+  S21MinorView(const S21ConstMatrixView& parent, int row, int col)
+      : parent_(parent), row_(row), col_(col) {
+    if (parent.GetRows() < 2 || parent.GetCols() < 2) {
+      throw std::logic_error("Wrong matrix size\n");
+    }
+    if (row < 0 || row >= parent.GetRows() || col < 0 ||
+        col >= parent.GetCols()) {
+      throw std::out_of_range("Incorrect input, index is out of range\n");
+    }
+  }
+
+  int GetRows() const { return parent_.GetRows() - 1; }
+  int GetCols() const { return parent_.GetCols() - 1; }
+
+  static constexpr bool kElementwise = false;
+  double At(int i, int j) const {
+    return parent_.At(i + (i >= row_), j + (j >= col_));
+  }
+  void Prepare() const {}
+  bool References(const double* begin, const double* end) const {
+    return parent_.References(begin, end);
+  }
+
+ private:
+  S21ConstMatrixView parent_;
+  int row_;
+  int col_;
+};
+
+inline S21MinorView S21ConstMatrixView::Minor(int row, int col) const {
+  return S21MinorView(*this, row, col);
+}
+
+#endif  // SRC_S21_MATRIX_VIEW_H_
@@ -0,0 +1,171 @@
+#include "s21_out_of_core.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "s21_gemm.h"
+#include "s21_matrix_io.h"
+
+namespace {
+
+// Tile buffers held at once: two of A, two of B and one of C.
+constexpr int kTileBuffers = 5;
+
+// One tile product: C(i, j) += A(i, p) * B(p, j), all tiles t x t at most.
+struct Step {
+  int i;
+  int j;
+  int p;
+};
+
+// Copies the rows x cols block of source at (row, col) into tile, whose rows
+// are ld elements apart.
+void CopyTile(const S21ConstMatrixView& source, int row, int col, int rows,
+              int cols, double* tile, int ld) {
+  for (int r = 0; r < rows; r++) {
+    const double* from = source.RowData(row + r) + col;
+    std::copy(from, from + cols, tile + static_cast<std::ptrdiff_t>(r) * ld);
+  }
+}
+
+// One background thread for the whole multiplication that runs load(step)
+// on request, so each prefetch is a handoff rather than a thread start.
+class Prefetcher {
+ public:
+  explicit Prefetcher(std::function<void(std::size_t)> load)
+      : load_(std::move(load)),
+        stop_(false),
+        busy_(false),
+        step_(0),
+        thread_(&Prefetcher::Loop, this) {}
+  Prefetcher(const Prefetcher&) = delete;
+  Prefetcher& operator=(const Prefetcher&) = delete;
+  // Lets a load in progress finish, as it writes into the caller's tiles.
+  ~Prefetcher() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+  }
+
+  // Starts load(step); the previous load must have been waited for.
+  void Start(std::size_t step) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      step_ = step;
+      busy_ = true;
+    }
+    wake_.notify_one();
+  }
+
+  // Waits for the load started last, rethrowing what it threw.
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return !busy_; });
+    if (error_) std::rethrow_exception(std::exchange(error_, nullptr));
+  }
+
+ private:
+  void Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      wake_.wait(lock, [this] { return stop_ || busy_; });
+      if (!busy_) break;
+      lock.unlock();
+      try {
+        load_(step_);
+      } catch (...) {
+        error_ = std::current_exception();
+      }
+      lock.lock();
+      busy_ = false;
+      done_.notify_one();
+    }
+  }
+
+  std::function<void(std::size_t)> load_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  bool stop_;
+  bool busy_;
+  std::size_t step_;
+  std::exception_ptr error_;
+  std::thread thread_;
+};
+
+}  // namespace
+
+int S21MultiplyFiles(const std::string& a_path, const std::string& b_path,
+                     const std::string& c_path, std::size_t memory_budget) {
+  S21MappedMatrix a(a_path);
+  S21MappedMatrix b(b_path);
+  int m = a.GetRows();
+  int k = a.GetCols();
+  int n = b.GetCols();
+  if (k != b.GetRows()) {
+    throw std::out_of_range(
+        "the number of columns of the first matrix does not equal the number "
+        "of rows of the second matrix\n");
+  }
+  int largest = std::max({m, n, k});
+  double fit = std::sqrt(static_cast<double>(memory_budget) /
+                         (kTileBuffers * sizeof(double)));
+  int t = static_cast<int>(std::min<double>(fit, largest + 7)) / 8 * 8;
+  t = std::max(t, 8);
+  S21MappedMatrix c = S21MappedMatrix::Create(c_path, m, n);
+
+  std::vector<Step> steps;
+  for (int i = 0; i < m; i += t) {
+    for (int j = 0; j < n; j += t) {
+      for (int p = 0; p < k; p += t) steps.push_back({i, j, p});
+    }
+  }
+  std::size_t area = static_cast<std::size_t>(t) * t;
+  std::unique_ptr<double[]> buffers(new double[kTileBuffers * area]);
+  double* a_tiles[2] = {buffers.get(), buffers.get() + area};
+  double* b_tiles[2] = {buffers.get() + 2 * area, buffers.get() + 3 * area};
+  double* c_tile = buffers.get() + 4 * area;
+  // Step s is loaded into the tiles s % 2.
+  auto load = [&](std::size_t s) {
+    const Step& step = steps[s];
+    int inner = std::min(t, k - step.p);
+    CopyTile(a.View(), step.i, step.p, std::min(t, m - step.i), inner,
+             a_tiles[s % 2], t);
+    CopyTile(b.View(), step.p, step.j, inner, std::min(t, n - step.j),
+             b_tiles[s % 2], t);
+  };
+
+  load(0);
+  Prefetcher prefetcher(load);
+  for (std::size_t s = 0; s < steps.size(); s++) {
+    bool prefetching = s + 1 < steps.size();
+    if (prefetching) prefetcher.Start(s + 1);
+    const Step& step = steps[s];
+    int rows = std::min(t, m - step.i);
+    int cols = std::min(t, n - step.j);
+    S21Gemm(rows, cols, std::min(t, k - step.p), 1.0, a_tiles[s % 2], t,
+            b_tiles[s % 2], t, step.p == 0 ? 0.0 : 1.0, c_tile, t);
+    if (step.p + t >= k) {
+      S21MatrixView out = c.MutableView().Block(step.i, step.j, rows, cols);
+      for (int r = 0; r < rows; r++) {
+        const double* from = c_tile + static_cast<std::ptrdiff_t>(r) * t;
+        std::copy(from, from + cols, out.RowData(r));
+      }
+    }
+    if (prefetching) prefetcher.Wait();
+  }
+  c.Flush();
+  return t;
+}
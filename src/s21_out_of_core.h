@@ -0,0 +1,25 @@
+#ifndef SRC_S21_OUT_OF_CORE_H_
+#define SRC_S21_OUT_OF_CORE_H_
+
+#include <cstddef>
+#include <string>
+
+// Memory S21MultiplyFiles works in when no budget is given.
+constexpr std::size_t kS21DefaultMemoryBudget = std::size_t{256} << 20;
+
+// Writes C = A * B to the matrix file c_path (see s21_matrix_io.h) for A and
+// B in matrix files too large to load. Each t x t tile of C is summed from
+// tile products computed by S21Gemm, the kernel behind MulMatrix, and
+// written to the mapped result once complete. While one product runs, a
+// single background thread, kept for the whole call, copies the next tiles
+// of A and B out of their mapped files, so reading the disk overlaps
+// computing. Two tiles of A, two of B
+// and one of C are held at a time; t is the largest multiple of 8 for which
+// they fit in memory_budget bytes, and is returned.
+// Throws std::out_of_range if the inner dimensions differ and
+// std::runtime_error on I/O errors.
+int S21MultiplyFiles(const std::string& a_path, const std::string& b_path,
+                     const std::string& c_path,
+                     std::size_t memory_budget = kS21DefaultMemoryBudget);
+
+#endif  // SRC_S21_OUT_OF_CORE_H_
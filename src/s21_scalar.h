@@ -0,0 +1,65 @@
+#ifndef SRC_S21_SCALAR_H_
+#define SRC_S21_SCALAR_H_
+
+#include <cmath>
+#include <complex>
+#include <limits>
+
+// What the matrix code needs to know about an element type: its real
+// component type, how many reals it holds and the absolute tolerance
+// EqMatrix compares with. Defined for float, double, long double and
+// std::complex of float and double.
+template <class T>
+struct S21ScalarTraits;
+
+template <>
+struct S21ScalarTraits<float> {
+  using Real = float;
+  static constexpr int kComponents = 1;
+  // About 100 ulps at magnitude 10, where 1e-7 would demand exact equality.
+  static constexpr float kEpsilon = 1e-4f;
+};
+
+template <>
+struct S21ScalarTraits<double> {
+  using Real = double;
+  static constexpr int kComponents = 1;
+  static constexpr double kEpsilon = 1e-7;
+};
+
+template <>
+struct S21ScalarTraits<long double> {
+  using Real = long double;
+  static constexpr int kComponents = 1;
+  static constexpr long double kEpsilon = 1e-7L;
+};
+
+// Complex elements compare their real and imaginary parts separately.
+template <class R>
+struct S21ScalarTraits<std::complex<R>> {
+  using Real = R;
+  static constexpr int kComponents = 2;
+  static constexpr R kEpsilon = S21ScalarTraits<R>::kEpsilon;
+};
+
+// |x| for real x, |re x| + |im x| for complex x: cheap, and good enough to
+// choose pivots with.
+template <class T>
+T S21Magnitude(T x) {
+  return std::fabs(x);
+}
+
+template <class R>
+R S21Magnitude(const std::complex<R>& x) {
+  return std::fabs(x.real()) + std::fabs(x.imag());
+}
+
+// Rounding noise of a pivot computed by an n-step elimination from entries
+// of magnitude scale. The factorizations take a pivot no larger than this
+// as zero, so numerically singular matrices are reported as singular.
+template <class R>
+constexpr R S21PivotTolerance(int n, R scale) {
+  return n * std::numeric_limits<R>::epsilon() * scale;
+}
+
+#endif  // SRC_S21_SCALAR_H_
@@ -0,0 +1,637 @@
+#include "s21_simd.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define S21_SIMD_X86 1
+#endif
+
+namespace {
+
+// ---------------------------------------------------------------- scalar --
+
+void GemmScalar(int kc, const double* a, const double* b, double* ab) {
+  constexpr int kMr = 4;
+  constexpr int kNr = 8;
+  double acc[kMr][kNr] = {};
+  for (int p = 0; p < kc; p++) {
+    for (int i = 0; i < kMr; i++) {
+      double ai = a[i];
+      for (int j = 0; j < kNr; j++) {
+        acc[i][j] += ai * b[j];
+      }
+    }
+    a += kMr;
+    b += kNr;
+  }
+  for (int i = 0; i < kMr; i++) {
+    for (int j = 0; j < kNr; j++) {
+      ab[i * kNr + j] = acc[i][j];
+    }
+  }
+}
+
+void AddScalar(std::size_t n, const double* x, double* y) {
+  for (std::size_t i = 0; i < n; i++) y[i] += x[i];
+}
+
+void SubScalar(std::size_t n, const double* x, double* y) {
+  for (std::size_t i = 0; i < n; i++) y[i] -= x[i];
+}
+
+void ScaleScalar(std::size_t n, double alpha, double* y) {
+  for (std::size_t i = 0; i < n; i++) y[i] *= alpha;
+}
+
+void AxpbyScalar(std::size_t n, double alpha, const double* x, double beta,
+                 double* y) {
+  for (std::size_t i = 0; i < n; i++) y[i] = alpha * x[i] + beta * y[i];
+}
+
+void MulAddScalar(std::size_t n, const double* x, const double* y,
+                  double* z) {
+  for (std::size_t i = 0; i < n; i++) z[i] += x[i] * y[i];
+}
+
+void MulScalar(std::size_t n, const double* x, double* y) {
+  for (std::size_t i = 0; i < n; i++) y[i] *= x[i];
+}
+
+void DivScalar(std::size_t n, const double* x, double* y) {
+  for (std::size_t i = 0; i < n; i++) y[i] /= x[i];
+}
+
+bool EqualScalar(std::size_t n, const double* x, const double* y, double eps) {
+  for (std::size_t i = 0; i < n; i++) {
+    double accuracy = x[i] - y[i];
+    if (accuracy > eps || accuracy < -eps) return false;
+  }
+  return true;
+}
+
+void TransposeScalar(const double* a, int lda, double* b, int ldb) {
+  for (int i = 0; i < kS21TransposeTile; i++) {
+    for (int j = 0; j < kS21TransposeTile; j++) {
+      b[j * ldb + i] = a[i * lda + j];
+    }
+  }
+}
+
+#ifdef S21_SIMD_X86
+
+// ------------------------------------------------------------------ SSE2 --
+
+__attribute__((target("sse2"))) void GemmSse2(int kc, const double* a,
+                                              const double* b, double* ab) {
+  constexpr int kMr = 4;
+  __m128d acc[kMr][2];
+  for (int i = 0; i < kMr; i++) {
+    acc[i][0] = _mm_setzero_pd();
+    acc[i][1] = _mm_setzero_pd();
+  }
+  for (int p = 0; p < kc; p++) {
+    __m128d b0 = _mm_loadu_pd(b);
+    __m128d b1 = _mm_loadu_pd(b + 2);
+#pragma GCC unroll 4
+    for (int i = 0; i < kMr; i++) {
+      __m128d ai = _mm_set1_pd(a[i]);
+      acc[i][0] = _mm_add_pd(acc[i][0], _mm_mul_pd(ai, b0));
+      acc[i][1] = _mm_add_pd(acc[i][1], _mm_mul_pd(ai, b1));
+    }
+    a += kMr;
+    b += 4;
+  }
+  for (int i = 0; i < kMr; i++) {
+    _mm_storeu_pd(ab + i * 4, acc[i][0]);
+    _mm_storeu_pd(ab + i * 4 + 2, acc[i][1]);
+  }
+}
+
+__attribute__((target("sse2"))) void AddSse2(std::size_t n, const double* x,
+                                             double* y) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] += x[i];
+}
+
+__attribute__((target("sse2"))) void SubSse2(std::size_t n, const double* x,
+                                             double* y) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(y + i, _mm_sub_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] -= x[i];
+}
+
+__attribute__((target("sse2"))) void ScaleSse2(std::size_t n, double alpha,
+                                               double* y) {
+  __m128d va = _mm_set1_pd(alpha);
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(y + i, _mm_mul_pd(_mm_loadu_pd(y + i), va));
+  }
+  for (; i < n; i++) y[i] *= alpha;
+}
+
+__attribute__((target("sse2"))) void AxpbySse2(std::size_t n, double alpha,
+                                               const double* x, double beta,
+                                               double* y) {
+  __m128d va = _mm_set1_pd(alpha);
+  __m128d vb = _mm_set1_pd(beta);
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(y + i, _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i)),
+                                    _mm_mul_pd(vb, _mm_loadu_pd(y + i))));
+  }
+  for (; i < n; i++) y[i] = alpha * x[i] + beta * y[i];
+}
+
+__attribute__((target("sse2"))) void MulAddSse2(std::size_t n,
+                                                const double* x,
+                                                const double* y, double* z) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d xy = _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i));
+    _mm_storeu_pd(z + i, _mm_add_pd(_mm_loadu_pd(z + i), xy));
+  }
+  for (; i < n; i++) z[i] += x[i] * y[i];
+}
+
+__attribute__((target("sse2"))) void MulSse2(std::size_t n, const double* x,
+                                             double* y) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(y + i, _mm_mul_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] *= x[i];
+}
+
+__attribute__((target("sse2"))) void DivSse2(std::size_t n, const double* x,
+                                             double* y) {
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    _mm_storeu_pd(y + i, _mm_div_pd(_mm_loadu_pd(y + i), _mm_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] /= x[i];
+}
+
+// |x - y| > eps for four vectors at a time, then one; a NaN difference
+// compares false and counts as a match, as in EqualScalar.
+__attribute__((target("sse2"))) bool EqualSse2(std::size_t n, const double* x,
+                                               const double* y, double eps) {
+  __m128d hi = _mm_set1_pd(eps);
+  __m128d lo = _mm_set1_pd(-eps);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128d out = _mm_setzero_pd();
+    for (int v = 0; v < 8; v += 2) {
+      __m128d d = _mm_sub_pd(_mm_loadu_pd(x + i + v), _mm_loadu_pd(y + i + v));
+      out = _mm_or_pd(out, _mm_or_pd(_mm_cmpgt_pd(d, hi), _mm_cmplt_pd(d, lo)));
+    }
+    if (_mm_movemask_pd(out) != 0) return false;
+  }
+  for (; i + 2 <= n; i += 2) {
+    __m128d d = _mm_sub_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i));
+    __m128d out = _mm_or_pd(_mm_cmpgt_pd(d, hi), _mm_cmplt_pd(d, lo));
+    if (_mm_movemask_pd(out) != 0) return false;
+  }
+  return EqualScalar(n - i, x + i, y + i, eps);
+}
+
+// The 8x8 tile as sixteen 2x2 unpacks.
+__attribute__((target("sse2"))) void TransposeSse2(const double* a, int lda,
+                                                   double* b, int ldb) {
+  for (int i = 0; i < kS21TransposeTile; i += 2) {
+    for (int j = 0; j < kS21TransposeTile; j += 2) {
+      __m128d r0 = _mm_loadu_pd(a + i * lda + j);
+      __m128d r1 = _mm_loadu_pd(a + (i + 1) * lda + j);
+      _mm_storeu_pd(b + j * ldb + i, _mm_unpacklo_pd(r0, r1));
+      _mm_storeu_pd(b + (j + 1) * ldb + i, _mm_unpackhi_pd(r0, r1));
+    }
+  }
+}
+
+// ---------------------------------------------------------------- AVX2 --
+
+__attribute__((target("avx2,fma"))) void GemmAvx2(int kc, const double* a,
+                                                  const double* b,
+                                                  double* ab) {
+  constexpr int kMr = 6;
+  __m256d acc[kMr][2];
+  for (int i = 0; i < kMr; i++) {
+    acc[i][0] = _mm256_setzero_pd();
+    acc[i][1] = _mm256_setzero_pd();
+  }
+  for (int p = 0; p < kc; p++) {
+    __m256d b0 = _mm256_loadu_pd(b);
+    __m256d b1 = _mm256_loadu_pd(b + 4);
+#pragma GCC unroll 6
+    for (int i = 0; i < kMr; i++) {
+      __m256d ai = _mm256_broadcast_sd(a + i);
+      acc[i][0] = _mm256_fmadd_pd(ai, b0, acc[i][0]);
+      acc[i][1] = _mm256_fmadd_pd(ai, b1, acc[i][1]);
+    }
+    a += kMr;
+    b += 8;
+  }
+  for (int i = 0; i < kMr; i++) {
+    _mm256_storeu_pd(ab + i * 8, acc[i][0]);
+    _mm256_storeu_pd(ab + i * 8 + 4, acc[i][1]);
+  }
+}
+
+__attribute__((target("avx2"))) void AddAvx2(std::size_t n, const double* x,
+                                             double* y) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(
+        y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] += x[i];
+}
+
+__attribute__((target("avx2"))) void SubAvx2(std::size_t n, const double* x,
+                                             double* y) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(
+        y + i, _mm256_sub_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] -= x[i];
+}
+
+__attribute__((target("avx2"))) void ScaleAvx2(std::size_t n, double alpha,
+                                               double* y) {
+  __m256d va = _mm256_set1_pd(alpha);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(y + i, _mm256_mul_pd(_mm256_loadu_pd(y + i), va));
+  }
+  for (; i < n; i++) y[i] *= alpha;
+}
+
+__attribute__((target("avx2,fma"))) void AxpbyAvx2(std::size_t n,
+                                                   double alpha,
+                                                   const double* x,
+                                                   double beta, double* y) {
+  __m256d va = _mm256_set1_pd(alpha);
+  __m256d vb = _mm256_set1_pd(beta);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d by = _mm256_mul_pd(vb, _mm256_loadu_pd(y + i));
+    _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), by));
+  }
+  for (; i < n; i++) y[i] = std::fma(alpha, x[i], beta * y[i]);
+}
+
+__attribute__((target("avx2,fma"))) void MulAddAvx2(std::size_t n,
+                                                    const double* x,
+                                                    const double* y,
+                                                    double* z) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(z + i, _mm256_fmadd_pd(_mm256_loadu_pd(x + i),
+                                            _mm256_loadu_pd(y + i),
+                                            _mm256_loadu_pd(z + i)));
+  }
+  for (; i < n; i++) z[i] = std::fma(x[i], y[i], z[i]);
+}
+
+__attribute__((target("avx2"))) void MulAvx2(std::size_t n, const double* x,
+                                             double* y) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(
+        y + i, _mm256_mul_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] *= x[i];
+}
+
+__attribute__((target("avx2"))) void DivAvx2(std::size_t n, const double* x,
+                                             double* y) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm256_storeu_pd(
+        y + i, _mm256_div_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] /= x[i];
+}
+
+__attribute__((target("avx2"))) bool EqualAvx2(std::size_t n, const double* x,
+                                               const double* y, double eps) {
+  __m256d hi = _mm256_set1_pd(eps);
+  __m256d lo = _mm256_set1_pd(-eps);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256d out = _mm256_setzero_pd();
+    for (int v = 0; v < 16; v += 4) {
+      __m256d d = _mm256_sub_pd(_mm256_loadu_pd(x + i + v),
+                                _mm256_loadu_pd(y + i + v));
+      out = _mm256_or_pd(out, _mm256_or_pd(_mm256_cmp_pd(d, hi, _CMP_GT_OQ),
+                                           _mm256_cmp_pd(d, lo, _CMP_LT_OQ)));
+    }
+    if (_mm256_movemask_pd(out) != 0) return false;
+  }
+  for (; i + 4 <= n; i += 4) {
+    __m256d d = _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i));
+    __m256d out = _mm256_or_pd(_mm256_cmp_pd(d, hi, _CMP_GT_OQ),
+                               _mm256_cmp_pd(d, lo, _CMP_LT_OQ));
+    if (_mm256_movemask_pd(out) != 0) return false;
+  }
+  return EqualScalar(n - i, x + i, y + i, eps);
+}
+
+// The 8x8 tile as four 4x4 register transposes.
+__attribute__((target("avx2"))) void TransposeAvx2(const double* a, int lda,
+                                                   double* b, int ldb) {
+  for (int i = 0; i < kS21TransposeTile; i += 4) {
+    for (int j = 0; j < kS21TransposeTile; j += 4) {
+      const double* src = a + i * lda + j;
+      __m256d r0 = _mm256_loadu_pd(src);
+      __m256d r1 = _mm256_loadu_pd(src + lda);
+      __m256d r2 = _mm256_loadu_pd(src + 2 * lda);
+      __m256d r3 = _mm256_loadu_pd(src + 3 * lda);
+      __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+      __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+      __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+      __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+      double* dst = b + j * ldb + i;
+      _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+      _mm256_storeu_pd(dst + ldb, _mm256_permute2f128_pd(t1, t3, 0x20));
+      _mm256_storeu_pd(dst + 2 * ldb, _mm256_permute2f128_pd(t0, t2, 0x31));
+      _mm256_storeu_pd(dst + 3 * ldb, _mm256_permute2f128_pd(t1, t3, 0x31));
+    }
+  }
+}
+
+// -------------------------------------------------------------- AVX-512 --
+
+__attribute__((target("avx512f"))) void GemmAvx512(int kc, const double* a,
+                                                   const double* b,
+                                                   double* ab) {
+  constexpr int kMr = 8;
+  __m512d acc[kMr][2];
+  for (int i = 0; i < kMr; i++) {
+    acc[i][0] = _mm512_setzero_pd();
+    acc[i][1] = _mm512_setzero_pd();
+  }
+  for (int p = 0; p < kc; p++) {
+    __m512d b0 = _mm512_loadu_pd(b);
+    __m512d b1 = _mm512_loadu_pd(b + 8);
+#pragma GCC unroll 8
+    for (int i = 0; i < kMr; i++) {
+      __m512d ai = _mm512_set1_pd(a[i]);
+      acc[i][0] = _mm512_fmadd_pd(ai, b0, acc[i][0]);
+      acc[i][1] = _mm512_fmadd_pd(ai, b1, acc[i][1]);
+    }
+    a += kMr;
+    b += 16;
+  }
+  for (int i = 0; i < kMr; i++) {
+    _mm512_storeu_pd(ab + i * 16, acc[i][0]);
+    _mm512_storeu_pd(ab + i * 16 + 8, acc[i][1]);
+  }
+}
+
+__attribute__((target("avx512f"))) void AddAvx512(std::size_t n,
+                                                  const double* x, double* y) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(
+        y + i, _mm512_add_pd(_mm512_loadu_pd(y + i), _mm512_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] += x[i];
+}
+
+__attribute__((target("avx512f"))) void SubAvx512(std::size_t n,
+                                                  const double* x, double* y) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(
+        y + i, _mm512_sub_pd(_mm512_loadu_pd(y + i), _mm512_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] -= x[i];
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(std::size_t n,
+                                                    double alpha, double* y) {
+  __m512d va = _mm512_set1_pd(alpha);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(y + i, _mm512_mul_pd(_mm512_loadu_pd(y + i), va));
+  }
+  for (; i < n; i++) y[i] *= alpha;
+}
+
+__attribute__((target("avx512f"))) void AxpbyAvx512(std::size_t n,
+                                                    double alpha,
+                                                    const double* x,
+                                                    double beta, double* y) {
+  __m512d va = _mm512_set1_pd(alpha);
+  __m512d vb = _mm512_set1_pd(beta);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d by = _mm512_mul_pd(vb, _mm512_loadu_pd(y + i));
+    _mm512_storeu_pd(y + i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), by));
+  }
+  for (; i < n; i++) y[i] = std::fma(alpha, x[i], beta * y[i]);
+}
+
+__attribute__((target("avx512f"))) void MulAddAvx512(std::size_t n,
+                                                     const double* x,
+                                                     const double* y,
+                                                     double* z) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(z + i, _mm512_fmadd_pd(_mm512_loadu_pd(x + i),
+                                            _mm512_loadu_pd(y + i),
+                                            _mm512_loadu_pd(z + i)));
+  }
+  for (; i < n; i++) z[i] = std::fma(x[i], y[i], z[i]);
+}
+
+__attribute__((target("avx512f"))) void MulAvx512(std::size_t n,
+                                                  const double* x, double* y) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(
+        y + i, _mm512_mul_pd(_mm512_loadu_pd(y + i), _mm512_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] *= x[i];
+}
+
+__attribute__((target("avx512f"))) void DivAvx512(std::size_t n,
+                                                  const double* x, double* y) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm512_storeu_pd(
+        y + i, _mm512_div_pd(_mm512_loadu_pd(y + i), _mm512_loadu_pd(x + i)));
+  }
+  for (; i < n; i++) y[i] /= x[i];
+}
+
+__attribute__((target("avx512f"))) bool EqualAvx512(std::size_t n,
+                                                    const double* x,
+                                                    const double* y,
+                                                    double eps) {
+  __m512d hi = _mm512_set1_pd(eps);
+  __m512d lo = _mm512_set1_pd(-eps);
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __mmask8 out = 0;
+    for (int v = 0; v < 32; v += 8) {
+      __m512d d = _mm512_sub_pd(_mm512_loadu_pd(x + i + v),
+                                _mm512_loadu_pd(y + i + v));
+      out |= _mm512_cmp_pd_mask(d, hi, _CMP_GT_OQ) |
+             _mm512_cmp_pd_mask(d, lo, _CMP_LT_OQ);
+    }
+    if (out != 0) return false;
+  }
+  for (; i + 8 <= n; i += 8) {
+    __m512d d = _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i));
+    if ((_mm512_cmp_pd_mask(d, hi, _CMP_GT_OQ) |
+         _mm512_cmp_pd_mask(d, lo, _CMP_LT_OQ)) != 0) {
+      return false;
+    }
+  }
+  return EqualScalar(n - i, x + i, y + i, eps);
+}
+
+// Full 8x8 transpose in registers: 2x2 interleaves, then 128-bit lanes,
+// then 256-bit halves. Every step is a two-source permute (the unpack and
+// shuffle intrinsics trip GCC 12's -Wuninitialized at -O3).
+__attribute__((target("avx512f"))) void TransposeAvx512(const double* a,
+                                                        int lda, double* b,
+                                                        int ldb) {
+  const __m512i lo2 = _mm512_set_epi64(14, 6, 12, 4, 10, 2, 8, 0);
+  const __m512i hi2 = _mm512_set_epi64(15, 7, 13, 5, 11, 3, 9, 1);
+  const __m512i lo4 = _mm512_set_epi64(13, 12, 5, 4, 9, 8, 1, 0);
+  const __m512i hi4 = _mm512_set_epi64(15, 14, 7, 6, 11, 10, 3, 2);
+  const __m512i lo8 = _mm512_set_epi64(11, 10, 9, 8, 3, 2, 1, 0);
+  const __m512i hi8 = _mm512_set_epi64(15, 14, 13, 12, 7, 6, 5, 4);
+  __m512d r[8];
+  for (int i = 0; i < 8; i++) r[i] = _mm512_loadu_pd(a + i * lda);
+  __m512d t[8];
+  for (int i = 0; i < 8; i += 2) {
+    t[i] = _mm512_permutex2var_pd(r[i], lo2, r[i + 1]);
+    t[i + 1] = _mm512_permutex2var_pd(r[i], hi2, r[i + 1]);
+  }
+  __m512d u[8];
+  for (int h = 0; h < 8; h += 4) {
+    u[h] = _mm512_permutex2var_pd(t[h], lo4, t[h + 2]);
+    u[h + 1] = _mm512_permutex2var_pd(t[h + 1], lo4, t[h + 3]);
+    u[h + 2] = _mm512_permutex2var_pd(t[h], hi4, t[h + 2]);
+    u[h + 3] = _mm512_permutex2var_pd(t[h + 1], hi4, t[h + 3]);
+  }
+  for (int j = 0; j < 4; j++) {
+    _mm512_storeu_pd(b + j * ldb, _mm512_permutex2var_pd(u[j], lo8, u[j + 4]));
+    _mm512_storeu_pd(b + (j + 4) * ldb,
+                     _mm512_permutex2var_pd(u[j], hi8, u[j + 4]));
+  }
+}
+
+#endif  // S21_SIMD_X86
+
+const S21Kernels kScalarKernels = {
+    S21Isa::kScalar, 4,           8,           GemmScalar,   AddScalar,
+    SubScalar,       ScaleScalar, AxpbyScalar, MulAddScalar, MulScalar,
+    DivScalar,       EqualScalar, TransposeScalar};
+#ifdef S21_SIMD_X86
+const S21Kernels kSse2Kernels = {
+    S21Isa::kSse2, 4,         4,         GemmSse2,   AddSse2,
+    SubSse2,       ScaleSse2, AxpbySse2, MulAddSse2, MulSse2,
+    DivSse2,       EqualSse2, TransposeSse2};
+const S21Kernels kAvx2Kernels = {
+    S21Isa::kAvx2, 6,         8,         GemmAvx2,   AddAvx2,
+    SubAvx2,       ScaleAvx2, AxpbyAvx2, MulAddAvx2, MulAvx2,
+    DivAvx2,       EqualAvx2, TransposeAvx2};
+const S21Kernels kAvx512Kernels = {
+    S21Isa::kAvx512, 8,           16,          GemmAvx512,   AddAvx512,
+    SubAvx512,       ScaleAvx512, AxpbyAvx512, MulAddAvx512, MulAvx512,
+    DivAvx512,       EqualAvx512, TransposeAvx512};
+#endif
+
+const S21Kernels* KernelsFor(S21Isa isa) {
+  const S21Kernels* kernels = &kScalarKernels;
+#ifdef S21_SIMD_X86
+  if (isa == S21Isa::kSse2) {
+    kernels = &kSse2Kernels;
+  } else if (isa == S21Isa::kAvx2) {
+    kernels = &kAvx2Kernels;
+  } else if (isa == S21Isa::kAvx512) {
+    kernels = &kAvx512Kernels;
+  }
+#else
+  (void)isa;
+#endif
+  return kernels;
+}
+
+S21Isa IsaFromEnvironment(S21Isa fallback) {
+  const char* name = std::getenv("S21_MATRIX_ISA");
+  S21Isa res = fallback;
+  if (name != nullptr) {
+    for (S21Isa isa : {S21Isa::kScalar, S21Isa::kSse2, S21Isa::kAvx2,
+                       S21Isa::kAvx512}) {
+      if (std::strcmp(name, S21IsaName(isa)) == 0) res = isa;
+    }
+  }
+  return res;
+}
+
+S21Isa Clamp(S21Isa isa) {
+  S21Isa best = S21DetectIsa();
+  return isa > best ? best : isa;
+}
+
+std::atomic<const S21Kernels*>& Active() {
+  static std::atomic<const S21Kernels*> active(
+      KernelsFor(Clamp(IsaFromEnvironment(S21DetectIsa()))));
+  return active;
+}
+
+}  // namespace
+
+S21Isa S21DetectIsa() {
+  S21Isa isa = S21Isa::kScalar;
+#ifdef S21_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    isa = S21Isa::kAvx512;
+  } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    isa = S21Isa::kAvx2;
+  } else if (__builtin_cpu_supports("sse2")) {
+    isa = S21Isa::kSse2;
+  }
+#endif
+  return isa;
+}
+
+S21Isa S21ForceIsa(S21Isa isa) {
+  isa = Clamp(isa);
+  Active().store(KernelsFor(isa), std::memory_order_release);
+  return isa;
+}
+
+const S21Kernels& S21GetKernels() {
+  return *Active().load(std::memory_order_acquire);
+}
+
+const char* S21IsaName(S21Isa isa) {
+  const char* name = "scalar";
+  if (isa == S21Isa::kSse2) {
+    name = "sse2";
+  } else if (isa == S21Isa::kAvx2) {
+    name = "avx2";
+  } else if (isa == S21Isa::kAvx512) {
+    name = "avx512";
+  }
+  return name;
+}
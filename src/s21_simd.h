@@ -0,0 +1,58 @@
+#ifndef SRC_S21_SIMD_H_
+#define SRC_S21_SIMD_H_
+
+#include <cstddef>
+
+// Instruction sets the library has kernels for, in increasing order.
+enum class S21Isa { kScalar, kSse2, kAvx2, kAvx512 };
+
+// Largest register tile any GEMM microkernel uses.
+constexpr int kS21MaxMr = 8;
+constexpr int kS21MaxNr = 16;
+
+// Edge of the square tile the transpose kernels work on.
+constexpr int kS21TransposeTile = 8;
+
+// Function table for one instruction set. Elementwise kernels work on n
+// contiguous doubles.
+struct S21Kernels {
+  S21Isa isa;
+  // ab (mr x nr, row-major) = packed A sliver (kc x mr) * packed B sliver
+  // (kc x nr).
+  int gemm_mr;
+  int gemm_nr;
+  void (*gemm)(int kc, const double* a, const double* b, double* ab);
+  // y += x, y -= x and y *= alpha.
+  void (*add)(std::size_t n, const double* x, double* y);
+  void (*sub)(std::size_t n, const double* x, double* y);
+  void (*scale)(std::size_t n, double alpha, double* y);
+  // y = alpha * x + beta * y, z += x * y, y *= x and y /= x, elementwise and
+  // in one pass. Where the instruction set has FMA the multiply-adds round
+  // once, tails included.
+  void (*axpby)(std::size_t n, double alpha, const double* x, double beta,
+                double* y);
+  void (*mul_add)(std::size_t n, const double* x, const double* y, double* z);
+  void (*mul)(std::size_t n, const double* x, double* y);
+  void (*div)(std::size_t n, const double* x, double* y);
+  // true when |x[i] - y[i]| <= eps for every i. Misses are tested a few
+  // vectors at a time, so it stops within one block of the first.
+  bool (*equal)(std::size_t n, const double* x, const double* y, double eps);
+  // b = a^T for one kS21TransposeTile square tile; a and b must not overlap.
+  void (*transpose)(const double* a, int lda, double* b, int ldb);
+};
+
+// Kernels picked for this process. On first use the best instruction set the
+// CPU supports is selected; the S21_MATRIX_ISA environment variable (scalar,
+// sse2, avx2 or avx512) caps the choice.
+const S21Kernels& S21GetKernels();
+
+// Switches every later call to the kernels for isa, or the best supported
+// one below it, and returns the instruction set actually selected.
+S21Isa S21ForceIsa(S21Isa isa);
+
+// Best instruction set this CPU supports.
+S21Isa S21DetectIsa();
+
+const char* S21IsaName(S21Isa isa);
+
+#endif  // SRC_S21_SIMD_H_
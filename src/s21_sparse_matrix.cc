@@ -0,0 +1,271 @@
+#include "s21_sparse_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Products below kParallelFlops stay on the calling thread.
+constexpr double kParallelFlops = 1 << 17;
+
+void CheckProduct(int cols, int rows) {
+  if (cols != rows) {
+    throw std::out_of_range(
+        "the number of columns of the first matrix does not equal the number "
+        "of rows of the second matrix\n");
+  }
+}
+
+// Calls body(begin, end) over ranges of the rows of a CSR matrix with
+// offsets, each holding about the same number of entries, in parallel when
+// the whole product costs flops.
+template <class Body>
+void ForRowRanges(const std::vector<int>& offsets, double flops,
+                  const Body& body) {
+  int rows = static_cast<int>(offsets.size()) - 1;
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  int threads = pool.GetThreads();
+  if (threads == 1 || rows < 2 || flops < kParallelFlops) {
+    body(0, rows);
+  } else {
+    int tasks = std::min(rows, 4 * threads);
+    // First row of task t: where the running entry count passes t / tasks.
+    auto first_row = [&](int task) {
+      long long target = static_cast<long long>(offsets.back()) * task / tasks;
+      return static_cast<int>(
+          std::lower_bound(offsets.begin(), offsets.end() - 1, target) -
+          offsets.begin());
+    };
+    pool.ParallelFor(tasks, [&](int task) {
+      int begin = first_row(task);
+      int end = task + 1 == tasks ? rows : first_row(task + 1);
+      if (begin < end) body(begin, end);
+    });
+  }
+}
+
+}  // namespace
+
+S21SparseMatrix::S21SparseMatrix(int rows, int cols)
+    : rows_(rows),
+      cols_(cols),
+      format_(S21SparseFormat::kCsr),
+      offsets_(rows + 1, 0) {
+  if (rows < 1 || cols < 1) {
+    throw std::logic_error("Wrong size of the Matrix");
+  }
+}
+
+S21SparseMatrix::S21SparseMatrix(int rows, int cols,
+                                 const std::vector<S21Triplet>& triplets)
+    : S21SparseMatrix(rows, cols) {
+  // Bucket the triplets by row, then sort and merge each row.
+  for (const S21Triplet& t : triplets) {
+    if (t.row < 0 || t.row >= rows_ || t.col < 0 || t.col >= cols_) {
+      throw std::out_of_range("Incorrect input, index is out of range\n");
+    }
+    offsets_[t.row + 1]++;
+  }
+  for (int i = 0; i < rows_; i++) offsets_[i + 1] += offsets_[i];
+  std::vector<std::pair<int, double>> entries(triplets.size());
+  std::vector<int> next(offsets_.begin(), offsets_.end() - 1);
+  for (const S21Triplet& t : triplets) {
+    entries[next[t.row]++] = {t.col, t.value};
+  }
+  indices_.reserve(entries.size());
+  values_.reserve(entries.size());
+  for (int i = 0; i < rows_; i++) {
+    auto begin = entries.begin() + offsets_[i];
+    auto end = entries.begin() + offsets_[i + 1];
+    std::sort(begin, end, [](const std::pair<int, double>& a,
+                             const std::pair<int, double>& b) {
+      return a.first < b.first;
+    });
+    offsets_[i] = static_cast<int>(values_.size());
+    for (auto it = begin; it != end;) {
+      int col = it->first;
+      double sum = 0.0;
+      for (; it != end && it->first == col; ++it) sum += it->second;
+      if (sum != 0.0) {
+        indices_.push_back(col);
+        values_.push_back(sum);
+      }
+    }
+  }
+  offsets_[rows_] = static_cast<int>(values_.size());
+}
+
+S21SparseMatrix::S21SparseMatrix(const S21ConstMatrixView& dense,
+                                 double drop_tolerance)
+    : S21SparseMatrix(dense.GetRows(), dense.GetCols()) {
+  for (int i = 0; i < rows_; i++) {
+    const double* row = dense.RowData(i);
+    for (int j = 0; j < cols_; j++) {
+      if (std::fabs(row[j]) > drop_tolerance) {
+        indices_.push_back(j);
+        values_.push_back(row[j]);
+      }
+    }
+    offsets_[i + 1] = static_cast<int>(values_.size());
+  }
+}
+
+double S21SparseMatrix::operator()(int i, int j) const {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_) {
+    throw std::out_of_range("Incorrect input, index is out of range\n");
+  }
+  int major = format_ == S21SparseFormat::kCsr ? i : j;
+  int minor = format_ == S21SparseFormat::kCsr ? j : i;
+  auto begin = indices_.begin() + offsets_[major];
+  auto end = indices_.begin() + offsets_[major + 1];
+  auto it = std::lower_bound(begin, end, minor);
+  return it != end && *it == minor ? values_[it - indices_.begin()] : 0.0;
+}
+
+S21SparseMatrix S21SparseMatrix::ToCsr() const {
+  return format_ == S21SparseFormat::kCsr ? *this : Converted();
+}
+
+S21SparseMatrix S21SparseMatrix::ToCsc() const {
+  return format_ == S21SparseFormat::kCsc ? *this : Converted();
+}
+
+S21Matrix S21SparseMatrix::ToDense() const {
+  S21Matrix dense(rows_, cols_);
+  double* out = dense.MutableData();
+  bool csr = format_ == S21SparseFormat::kCsr;
+  for (int major = 0; major < Majors(); major++) {
+    for (int k = offsets_[major]; k < offsets_[major + 1]; k++) {
+      int i = csr ? major : indices_[k];
+      int j = csr ? indices_[k] : major;
+      out[static_cast<std::ptrdiff_t>(i) * dense.Stride() + j] = values_[k];
+    }
+  }
+  return dense;
+}
+
+std::vector<double> S21SparseMatrix::MulVector(
+    const std::vector<double>& x) const {
+  CheckProduct(cols_, static_cast<int>(x.size()));
+  if (format_ != S21SparseFormat::kCsr) {
+    // Column-wise products scatter into y; rows parallelize without races.
+    return Converted().MulVector(x);
+  }
+  std::vector<double> y(rows_);
+  ForRowRanges(offsets_, 2.0 * NonZeros(), [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double sum = 0.0;
+      for (int k = offsets_[i]; k < offsets_[i + 1]; k++) {
+        sum += values_[k] * x[indices_[k]];
+      }
+      y[i] = sum;
+    }
+  });
+  return y;
+}
+
+S21Matrix S21SparseMatrix::MulMatrix(const S21ConstMatrixView& b) const {
+  CheckProduct(cols_, b.GetRows());
+  if (format_ != S21SparseFormat::kCsr) {
+    return Converted().MulMatrix(b);
+  }
+  S21Matrix c(rows_, b.GetCols());
+  int n = b.GetCols();
+  // MutableData() may detach c, so it is called once, not per worker.
+  double* out = c.MutableData();
+  int stride = c.Stride();
+  ForRowRanges(offsets_, 2.0 * NonZeros() * n, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      double* row = out + static_cast<std::ptrdiff_t>(i) * stride;
+      for (int k = offsets_[i]; k < offsets_[i + 1]; k++) {
+        double value = values_[k];
+        const double* b_row = b.RowData(indices_[k]);
+        for (int j = 0; j < n; j++) row[j] += value * b_row[j];
+      }
+    }
+  });
+  return c;
+}
+
+S21SparseMatrix S21SparseMatrix::SumMatrix(
+    const S21SparseMatrix& other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw std::logic_error("Matrix sizes are not identical\n");
+  }
+  if (format_ != S21SparseFormat::kCsr ||
+      other.format_ != S21SparseFormat::kCsr) {
+    return ToCsr().SumMatrix(other.ToCsr());
+  }
+  S21SparseMatrix sum(rows_, cols_);
+  sum.indices_.reserve(values_.size() + other.values_.size());
+  sum.values_.reserve(values_.size() + other.values_.size());
+  for (int i = 0; i < rows_; i++) {
+    // Merge the two sorted rows.
+    int k = offsets_[i];
+    int l = other.offsets_[i];
+    while (k < offsets_[i + 1] || l < other.offsets_[i + 1]) {
+      int col = cols_;
+      if (k < offsets_[i + 1]) col = indices_[k];
+      if (l < other.offsets_[i + 1]) col = std::min(col, other.indices_[l]);
+      double value = 0.0;
+      if (k < offsets_[i + 1] && indices_[k] == col) value += values_[k++];
+      if (l < other.offsets_[i + 1] && other.indices_[l] == col) {
+        value += other.values_[l++];
+      }
+      if (value != 0.0) {
+        sum.indices_.push_back(col);
+        sum.values_.push_back(value);
+      }
+    }
+    sum.offsets_[i + 1] = static_cast<int>(sum.values_.size());
+  }
+  return sum;
+}
+
+S21SparseMatrix S21SparseMatrix::Transpose() const {
+  S21SparseMatrix transpose(*this);
+  std::swap(transpose.rows_, transpose.cols_);
+  transpose.format_ = format_ == S21SparseFormat::kCsr
+                          ? S21SparseFormat::kCsc
+                          : S21SparseFormat::kCsr;
+  return transpose;
+}
+
+S21SparseMatrix S21SparseMatrix::Converted() const {
+  // Counting sort by minor index; walking the majors in order leaves every
+  // new segment sorted.
+  S21SparseMatrix res(rows_, cols_);
+  res.format_ = format_ == S21SparseFormat::kCsr ? S21SparseFormat::kCsc
+                                                  : S21SparseFormat::kCsr;
+  res.offsets_.assign(Minors() + 1, 0);
+  for (int index : indices_) res.offsets_[index + 1]++;
+  for (int m = 0; m < Minors(); m++) res.offsets_[m + 1] += res.offsets_[m];
+  res.indices_.resize(indices_.size());
+  res.values_.resize(values_.size());
+  std::vector<int> next(res.offsets_.begin(), res.offsets_.end() - 1);
+  for (int major = 0; major < Majors(); major++) {
+    for (int k = offsets_[major]; k < offsets_[major + 1]; k++) {
+      int position = next[indices_[k]]++;
+      res.indices_[position] = major;
+      res.values_[position] = values_[k];
+    }
+  }
+  return res;
+}
+
+S21SparseMatrix operator+(const S21SparseMatrix& a, const S21SparseMatrix& b) {
+  return a.SumMatrix(b);
+}
+
+std::vector<double> operator*(const S21SparseMatrix& a,
+                              const std::vector<double>& x) {
+  return a.MulVector(x);
+}
+
+S21Matrix operator*(const S21SparseMatrix& a, const S21ConstMatrixView& b) {
+  return a.MulMatrix(b);
+}
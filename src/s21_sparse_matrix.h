@@ -0,0 +1,84 @@
+#ifndef SRC_S21_SPARSE_MATRIX_H_
+#define SRC_S21_SPARSE_MATRIX_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// One entry of a sparse matrix being assembled.
+struct S21Triplet {
+  int row;
+  int col;
+  double value;
+};
+
+// Compressed sparse row: the entries of row i are indices[k] (columns) and
+// values[k] for offsets[i] <= k < offsets[i + 1]. Compressed sparse column
+// is the same with rows and columns exchanged.
+enum class S21SparseFormat { kCsr, kCsc };
+
+// A matrix that stores only its non-zero entries, compressed by row or by
+// column. Within a row (column) the entries are sorted by column (row) with
+// no duplicates and no explicit zeros. Products with dense operands run on
+// S21ThreadPool, split into row ranges with about the same number of
+// entries.
+class S21SparseMatrix {
+ public:
+  // rows x cols zero matrix in CSR.
+  S21SparseMatrix(int rows, int cols);
+  // CSR from unordered triplets; duplicates are summed.
+  S21SparseMatrix(int rows, int cols, const std::vector<S21Triplet>& triplets);
+  // CSR holding the entries of dense with |a(i, j)| > drop_tolerance.
+  explicit S21SparseMatrix(const S21ConstMatrixView& dense,
+                           double drop_tolerance = 0.0);
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+  int NonZeros() const { return static_cast<int>(values_.size()); }
+  S21SparseFormat Format() const { return format_; }
+  const std::vector<int>& Offsets() const { return offsets_; }
+  const std::vector<int>& Indices() const { return indices_; }
+  const std::vector<double>& Values() const { return values_; }
+
+  // Element (i, j), 0 if it is not stored.
+  double operator()(int i, int j) const;
+
+  S21SparseMatrix ToCsr() const;
+  S21SparseMatrix ToCsc() const;
+  S21Matrix ToDense() const;
+
+  // A * x for x of GetCols() elements.
+  std::vector<double> MulVector(const std::vector<double>& x) const;
+  // A * b for dense b.
+  S21Matrix MulMatrix(const S21ConstMatrixView& b) const;
+  // A + other, in CSR. Entries that cancel are dropped.
+  S21SparseMatrix SumMatrix(const S21SparseMatrix& other) const;
+  // A^T, without reordering: the transpose of a CSR matrix is the CSC
+  // matrix with the same offsets, indices and values, and vice versa.
+  S21SparseMatrix Transpose() const;
+
+ private:
+  // Major and minor dimensions of the format.
+  int Majors() const {
+    return format_ == S21SparseFormat::kCsr ? rows_ : cols_;
+  }
+  int Minors() const {
+    return format_ == S21SparseFormat::kCsr ? cols_ : rows_;
+  }
+  // The same matrix compressed along the other dimension.
+  S21SparseMatrix Converted() const;
+
+  int rows_;
+  int cols_;
+  S21SparseFormat format_;
+  std::vector<int> offsets_;
+  std::vector<int> indices_;
+  std::vector<double> values_;
+};
+
+S21SparseMatrix operator+(const S21SparseMatrix& a, const S21SparseMatrix& b);
+std::vector<double> operator*(const S21SparseMatrix& a,
+                              const std::vector<double>& x);
+S21Matrix operator*(const S21SparseMatrix& a, const S21ConstMatrixView& b);
+
+#endif  // SRC_S21_SPARSE_MATRIX_H_
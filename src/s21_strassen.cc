@@ -0,0 +1,131 @@
+#include "s21_strassen.h"
+
+#include <memory>
+
+#include "s21_gemm.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// out = x + sign * y for rows x cols blocks.
+void Combine(int rows, int cols, const double* x, int ldx, const double* y,
+             int ldy, double sign, double* out, int ldo) {
+  for (int i = 0; i < rows; i++) {
+    const double* xi = x + i * ldx;
+    const double* yi = y + i * ldy;
+    double* oi = out + i * ldo;
+    for (int j = 0; j < cols; j++) {
+      oi[j] = xi[j] + sign * yi[j];
+    }
+  }
+}
+
+// x += sign * y, both dense rows x cols.
+void Accumulate(int count, const double* y, double sign, double* x) {
+  for (int i = 0; i < count; i++) {
+    x[i] += sign * y[i];
+  }
+}
+
+struct Operand {
+  const double* data;
+  int ld;
+};
+
+void Strassen(int m, int n, int k, const double* a, int lda, const double* b,
+              int ldb, double* c, int ldc, int cutoff, bool top) {
+  if (m <= cutoff || n <= cutoff || k <= cutoff) {
+    S21Gemm(m, n, k, 1.0, a, lda, b, ldb, 0.0, c, ldc);
+    return;
+  }
+  int m2 = m / 2;
+  int n2 = n / 2;
+  int k2 = k / 2;
+  const double* a11 = a;
+  const double* a12 = a + k2;
+  const double* a21 = a + m2 * lda;
+  const double* a22 = a21 + k2;
+  const double* b11 = b;
+  const double* b12 = b + n2;
+  const double* b21 = b + k2 * ldb;
+  const double* b22 = b21 + n2;
+
+  int size_a = m2 * k2;
+  int size_b = k2 * n2;
+  int size_c = m2 * n2;
+  // Every temporary is fully overwritten, so skip value-initialization.
+  std::unique_ptr<double[]> s(new double[4 * size_a]);
+  std::unique_ptr<double[]> t(new double[4 * size_b]);
+  std::unique_ptr<double[]> p(new double[7 * size_c]);
+  double* s1 = s.get();
+  double* s2 = s1 + size_a;
+  double* s3 = s2 + size_a;
+  double* s4 = s3 + size_a;
+  double* t1 = t.get();
+  double* t2 = t1 + size_b;
+  double* t3 = t2 + size_b;
+  double* t4 = t3 + size_b;
+  Combine(m2, k2, a21, lda, a22, lda, 1.0, s1, k2);
+  Combine(m2, k2, s1, k2, a11, lda, -1.0, s2, k2);
+  Combine(m2, k2, a11, lda, a21, lda, -1.0, s3, k2);
+  Combine(m2, k2, a12, lda, s2, k2, -1.0, s4, k2);
+  Combine(k2, n2, b12, ldb, b11, ldb, -1.0, t1, n2);
+  Combine(k2, n2, b22, ldb, t1, n2, -1.0, t2, n2);
+  Combine(k2, n2, b22, ldb, b12, ldb, -1.0, t3, n2);
+  Combine(k2, n2, t2, n2, b21, ldb, -1.0, t4, n2);
+
+  const Operand lhs[7] = {{a11, lda}, {a12, lda}, {s4, k2}, {a22, lda},
+                          {s1, k2},   {s2, k2},   {s3, k2}};
+  const Operand rhs[7] = {{b11, ldb}, {b21, ldb}, {b22, ldb}, {t4, n2},
+                          {t1, n2},   {t2, n2},   {t3, n2}};
+  auto product = [&](int i) {
+    Strassen(m2, n2, k2, lhs[i].data, lhs[i].ld, rhs[i].data, rhs[i].ld,
+             p.get() + i * size_c, n2, cutoff, false);
+  };
+  if (top) {
+    S21ThreadPool::Instance().ParallelFor(7, product);
+  } else {
+    for (int i = 0; i < 7; i++) product(i);
+  }
+
+  double* p1 = p.get();
+  double* p2 = p1 + size_c;
+  double* p3 = p2 + size_c;
+  double* p4 = p3 + size_c;
+  double* p5 = p4 + size_c;
+  double* p6 = p5 + size_c;
+  double* p7 = p6 + size_c;
+  double* c11 = c;
+  double* c12 = c + n2;
+  double* c21 = c + m2 * ldc;
+  double* c22 = c21 + n2;
+  Combine(m2, n2, p1, n2, p2, n2, 1.0, c11, ldc);  // C11 = P1 + P2
+  Accumulate(size_c, p1, 1.0, p6);                  // U2 = P1 + P6
+  Accumulate(size_c, p6, 1.0, p7);                  // U3 = U2 + P7
+  Accumulate(size_c, p5, 1.0, p6);                  // U4 = U2 + P5
+  Combine(m2, n2, p6, n2, p3, n2, 1.0, c12, ldc);   // C12 = U4 + P3
+  Combine(m2, n2, p7, n2, p5, n2, 1.0, c22, ldc);   // C22 = U3 + P5
+  Combine(m2, n2, p7, n2, p4, n2, -1.0, c21, ldc);  // C21 = U3 - P4
+
+  // Peel whatever the even-sized recursion left out.
+  int me = 2 * m2;
+  int ne = 2 * n2;
+  int ke = 2 * k2;
+  if (k != ke) {
+    S21Gemm(me, ne, 1, 1.0, a + ke, lda, b + ke * ldb, ldb, 1.0, c, ldc);
+  }
+  if (n != ne) {
+    S21Gemm(me, 1, k, 1.0, a, lda, b + ne, ldb, 0.0, c + ne, ldc);
+  }
+  if (m != me) {
+    S21Gemm(1, n, k, 1.0, a + me * lda, lda, b, ldb, 0.0, c + me * ldc, ldc);
+  }
+}
+
+}  // namespace
+
+void S21StrassenGemm(int m, int n, int k, const double* a, int lda,
+                     const double* b, int ldb, double* c, int ldc,
+                     int cutoff) {
+  Strassen(m, n, k, a, lda, b, ldb, c, ldc, cutoff, true);
+}
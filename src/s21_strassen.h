@@ -0,0 +1,25 @@
+#ifndef SRC_S21_STRASSEN_H_
+#define SRC_S21_STRASSEN_H_
+
+// Products with any dimension at or below the cutoff go to S21Gemm.
+constexpr int kS21StrassenCutoff = 1024;
+
+// C = A * B with the Strassen-Winograd recursion (7 half-size products and
+// 15 additions per level) for row-major A (m x k), B (k x n) and C (m x n).
+// Odd dimensions are peeled: the even leading part recurses and the last
+// row, column or rank-one update is done by S21Gemm. The 7 products of the
+// top level run in parallel on S21ThreadPool.
+//
+// Error bound (Higham, "Accuracy and Stability of Numerical Algorithms",
+// 23.2.2): for n x n operands, d levels of recursion and a cutoff n0 = n / 2^d
+//   max|C - fl(C)| <= ((n / n0)^log2(18) * (n0^2 + 6 * n0) - 6 * n)
+//                     * u * max|A| * max|B| + O(u^2),
+// with u the unit roundoff. This is normwise only: unlike the classical
+// product, whose error is bounded by n * u * |A| * |B| elementwise, entries
+// of C that are small compared with the largest entries of A and B can lose
+// all their relative accuracy. Use it for well-scaled operands.
+void S21StrassenGemm(int m, int n, int k, const double* a, int lda,
+                     const double* b, int ldb, double* c, int ldc,
+                     int cutoff = kS21StrassenCutoff);
+
+#endif  // SRC_S21_STRASSEN_H_
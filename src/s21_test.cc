@@ -1,6 +1,26 @@
 #include <gtest/gtest.h>
 
+#include <cfloat>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "s21_allocator.h"
+#include "s21_basic_matrix.h"
+#include "s21_factorization.h"
+#include "s21_fixed_matrix.h"
+#include "s21_instrument.h"
+#include "s21_matrix_batch.h"
+#include "s21_matrix_io.h"
 #include "s21_matrix_oop.h"
+#include "s21_out_of_core.h"
+#include "s21_simd.h"
+#include "s21_sparse_matrix.h"
+#include "s21_strassen.h"
+#include "s21_thread_pool.h"
 
 TEST(Constructor, test1) {
   S21Matrix a;
@@ -40,6 +60,17 @@ TEST(SetRows, test2_throw) {
   EXPECT_THROW(a.SetRows(-1), std::logic_error);
 }
 
+TEST(SetRows, test3_keeps_values) {
+  S21Matrix a(3, 3);
+  a.SetMatrixIncremented(1);
+  a.SetRows(4);
+  EXPECT_EQ(a(2, 2), 9);
+  EXPECT_EQ(a(3, 0), 0);
+  a.SetRows(2);
+  EXPECT_EQ(a.GetRows(), 2);
+  EXPECT_EQ(a(1, 2), 6);
+}
+
 TEST(SetCols, test1) {
   S21Matrix a(3, 3);
   a.SetCols(5);
@@ -51,6 +82,17 @@ TEST(SetCols, test2_throw) {
   EXPECT_THROW(a.SetCols(-1), std::logic_error);
 }
 
+TEST(SetCols, test3_keeps_values) {
+  S21Matrix a(2, 9);
+  a.SetMatrixIncremented(1);
+  a.SetCols(10);
+  EXPECT_EQ(a(1, 8), 18);
+  EXPECT_EQ(a(1, 9), 0);
+  a.SetCols(3);
+  EXPECT_EQ(a.GetCols(), 3);
+  EXPECT_EQ(a(1, 2), 12);
+}
+
 TEST(Move, test1) {
   S21Matrix B(4, 8);
 
@@ -77,6 +119,51 @@ TEST(Move, test2) {
   }
 }
 
+TEST(Move, test3_assignment) {
+  static_assert(std::is_nothrow_move_constructible<S21Matrix>::value, "");
+  static_assert(std::is_nothrow_move_assignable<S21Matrix>::value, "");
+  S21Matrix a(3, 4);
+  a.SetMatrixIncremented(1);
+  const double* buffer = a.Data();
+  S21Matrix b(2, 2);
+  b = std::move(a);
+  EXPECT_EQ(b.Data(), buffer);
+  EXPECT_EQ(b.GetRows(), 3);
+  EXPECT_EQ(b(2, 3), 12);
+  a = b;
+  EXPECT_TRUE(a == b);
+  const double* reused = a.Data();
+  a = b;
+  EXPECT_EQ(a.Data(), reused);
+  a = a;
+  EXPECT_EQ(a(2, 3), 12);
+}
+
+TEST(Move, test4_vector_relocation) {
+  std::vector<S21Matrix> matrices;
+  matrices.emplace_back(2, 2);
+  const double* buffer = matrices[0].Data();
+  for (int i = 0; i < 20; i++) matrices.emplace_back(3, 3);
+  EXPECT_EQ(matrices[0].Data(), buffer);
+}
+
+TEST(Move, test5_rvalue_operators_reuse_buffer) {
+  S21Matrix b(2, 3);
+  b.SetMatrix(1);
+  S21Matrix tmp(2, 3);
+  tmp.SetMatrixIncremented(1);
+  const double* buffer = tmp.Data();
+  S21Matrix sum = std::move(tmp) + b * 2.0;
+  EXPECT_EQ(sum.Data(), buffer);
+  EXPECT_EQ(sum(1, 2), 8);
+  S21Matrix diff = b - std::move(sum);
+  EXPECT_EQ(diff.Data(), buffer);
+  EXPECT_EQ(diff(1, 2), -7);
+  S21Matrix scaled = 3.0 * std::move(diff);
+  EXPECT_EQ(scaled.Data(), buffer);
+  EXPECT_EQ(scaled(0, 0), -6);
+}
+
 TEST(EqMatrix, test1) {
   S21Matrix a(4, 4);
   S21Matrix b(4, 4);
@@ -282,6 +369,50 @@ TEST(MulMatrix, test3) {
   EXPECT_THROW(a.MulMatrix(b), std::out_of_range);
 }
 
+TEST(MulMatrix, test4_blocked_odd_sizes) {
+  // Larger than one register tile and one kKc panel in every dimension.
+  const int m = 37, k = 301, n = 45;
+  S21Matrix a(m, k);
+  S21Matrix b(k, n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < k; j++) a(i, j) = (i * 7 + j * 3) % 11 - 5;
+  }
+  for (int i = 0; i < k; i++) {
+    for (int j = 0; j < n; j++) b(i, j) = (i * 5 + j * 2) % 13 - 6;
+  }
+  S21Matrix expected(m, n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      for (int p = 0; p < k; p++) expected(i, j) += a(i, p) * b(p, j);
+    }
+  }
+  a.MulMatrix(b);
+  EXPECT_EQ(a.GetRows(), m);
+  EXPECT_EQ(a.GetCols(), n);
+  EXPECT_TRUE(a.EqMatrix(expected));
+}
+
+TEST(MulMatrix, test5_strassen_matches_blocked) {
+  // A small cutoff forces two levels of recursion and every peeling case.
+  const int m = 75, k = 67, n = 81;
+  S21Matrix a(m, k);
+  S21Matrix b(k, n);
+  a.SetMatrixIncremented(-2000);
+  b.SetMatrixIncremented(0.5);
+  S21Matrix expected = a * b;
+  S21Matrix c(m, n);
+  S21StrassenGemm(m, n, k, a.Data(), a.Stride(), b.Data(), b.Stride(),
+                  c.Data(), c.Stride(), 16);
+  S21Matrix error = c - expected;
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      EXPECT_NEAR(error(i, j) / std::abs(expected(i, j)), 0, 1e-12);
+    }
+  }
+  a.MulMatrix(b, S21MulAlgorithm::kStrassen);
+  EXPECT_TRUE(a == expected);
+}
+
 TEST(Transpose, test1) {
   S21Matrix a(2, 2);
   a.SetMatrixIncremented(9.9);
@@ -303,6 +434,47 @@ TEST(Transpose, test2) {
   EXPECT_THROW(a.Transpose(), std::logic_error);
 }
 
+TEST(Transpose, test3_blocked_rectangular) {
+  S21Matrix a(45, 83);
+  a.SetMatrixIncremented(-1000);
+  for (S21Isa isa : {S21Isa::kScalar, S21Isa::kSse2, S21Isa::kAvx2,
+                     S21Isa::kAvx512}) {
+    S21ForceIsa(isa);
+    S21Matrix b = a.Transpose();
+    ASSERT_EQ(b.GetRows(), 83);
+    ASSERT_EQ(b.GetCols(), 45);
+    for (int i = 0; i < 45; i++) {
+      for (int j = 0; j < 83; j++) {
+        ASSERT_EQ(b(j, i), a(i, j)) << S21IsaName(isa);
+      }
+    }
+    b = b.Transpose();
+    EXPECT_TRUE(b == a);
+  }
+  S21ForceIsa(S21DetectIsa());
+}
+
+TEST(Transpose, test4_in_place_square) {
+  S21Matrix a(37, 37);
+  a.SetMatrixIncremented(0.5);
+  S21Matrix original(a);
+  for (S21Isa isa : {S21Isa::kScalar, S21Isa::kSse2, S21Isa::kAvx2,
+                     S21Isa::kAvx512}) {
+    S21ForceIsa(isa);
+    const double* data = a.Data();
+    a = a.Transpose();
+    EXPECT_EQ(a.Data(), data);
+    for (int i = 0; i < 37; i++) {
+      for (int j = 0; j < 37; j++) {
+        ASSERT_EQ(a(i, j), original(j, i)) << S21IsaName(isa);
+      }
+    }
+    a = a.Transpose();
+    EXPECT_TRUE(a == original);
+  }
+  S21ForceIsa(S21DetectIsa());
+}
+
 TEST(CalcComplements, test1) {
   S21Matrix a(5, 2);
   ASSERT_THROW(a.CalcComplements(), std::logic_error);
@@ -558,6 +730,44 @@ TEST(Determinant, testSeven) {
   ASSERT_THROW(a.Determinant(), std::logic_error);
 }
 
+TEST(Determinant, testEight12x12) {
+  // det(2I + J) = 2^(n - 1) * (2 + n) for the all-ones matrix J.
+  S21Matrix a(12, 12);
+  a.SetMatrix(1);
+  for (int i = 0; i < 12; i++) a(i, i) = 3;
+  EXPECT_NEAR(a.Determinant(), 28672, 1e-7);
+}
+
+TEST(Determinant, testNinePivoting) {
+  // A cyclic shift of four rows is an odd permutation.
+  S21Matrix a(4, 4);
+  a(0, 1) = 1;
+  a(1, 2) = 1;
+  a(2, 3) = 1;
+  a(3, 0) = 1;
+  EXPECT_EQ(a.Determinant(), -1);
+}
+
+TEST(Determinant, testTenSingular) {
+  S21Matrix a(70, 70);
+  a.SetMatrixIncremented(1);
+  for (int j = 0; j < 70; j++) a(69, j) = a(3, j);
+  EXPECT_NEAR(a.Determinant(), 0, 1e-7);
+  S21Matrix zero(5, 5);
+  EXPECT_EQ(zero.Determinant(), 0);
+}
+
+TEST(Determinant, testElevenNearSingularPivots) {
+  // Rank 2: elimination leaves pivots of rounding noise, not exact zeros.
+  for (int n : {4, 5, 9}) {
+    S21Matrix a(n, n);
+    a.SetMatrixIncremented(1);
+    EXPECT_EQ(a.Determinant(), 0) << n;
+    S21MatrixF f = S21MatrixCast<float>(a);
+    EXPECT_EQ(f.Determinant(), 0.0f) << n;
+  }
+}
+
 TEST(InverseMatrix, test1) {
   S21Matrix a(4, 4);
   ASSERT_THROW(a.InverseMatrix(), std::out_of_range);
@@ -628,6 +838,82 @@ TEST(InverseMatrix, testThreedetEqNegative1) {
   EXPECT_EQ(compare, true);
 }
 
+TEST(InverseMatrix, testFourLarge) {
+  const int n = 150;
+  S21Matrix a(n, n);
+  a.SetMatrixIncremented(-3);
+  for (int i = 0; i < n; i++) a(i, i) += 5 * n * n;
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1;
+  S21Matrix inverse = a.InverseMatrix();
+  EXPECT_TRUE(a * inverse == identity);
+}
+
+TEST(InverseMatrix, testFiveSingularAndOneByOne) {
+  S21Matrix a(6, 6);
+  a.SetMatrixIncremented(1);
+  EXPECT_THROW(a.InverseMatrix(), std::out_of_range);
+  S21Matrix b(1, 1);
+  b(0, 0) = 4;
+  EXPECT_EQ(b.InverseMatrix()(0, 0), 0.25);
+  S21Matrix c(2, 3);
+  EXPECT_THROW(c.InverseMatrix(), std::logic_error);
+}
+
+TEST(InverseMatrix, testSixNearSingularPivots) {
+  // Rank 2 for every n: the factorization is left with pivots of rounding
+  // noise, which must not be inverted.
+  for (int n : {3, 4, 5}) {
+    S21Matrix a(n, n);
+    a.SetMatrixIncremented(1);
+    EXPECT_EQ(a.Determinant(), 0) << n;
+    EXPECT_THROW(a.InverseMatrix(), std::out_of_range) << n;
+    // Past 3 x 3 the complements come from the same factorization; the
+    // adjugate of a matrix of rank n - 2 is zero.
+    if (n > 3) {
+      EXPECT_TRUE(a.CalcComplements() == S21Matrix(n, n)) << n;
+    }
+  }
+}
+
+TEST(CalcComplements, test8AdjugateIdentity) {
+  // A * adj(A) = det(A) * I with adj(A) the transposed complements.
+  const int n = 6;
+  S21Matrix a(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = (i * 3 + j * 5) % 7 - 2 + (i == j);
+  }
+  double det = a.Determinant();
+  ASSERT_NE(det, 0.0);
+  S21Matrix complements = a.CalcComplements();
+  S21Matrix expected(n, n);
+  for (int i = 0; i < n; i++) expected(i, i) = det;
+  S21Matrix product(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      for (int k = 0; k < n; k++) product(i, j) += a(i, k) * complements(j, k);
+    }
+  }
+  EXPECT_TRUE(product == expected);
+}
+
+TEST(CalcComplements, test9SingularFallback) {
+  // Rank n - 1: the adjugate is non-zero but A * adj(A) still vanishes.
+  const int n = 5;
+  S21Matrix a(n, n);
+  for (int i = 0; i < n - 1; i++) a(i, i) = i + 2;
+  for (int j = 0; j < n; j++) a(n - 1, j) = a(0, j) + a(1, j);
+  S21Matrix complements = a.CalcComplements();
+  EXPECT_EQ(complements(4, 4), 2 * 3 * 4 * 5);
+  S21Matrix product(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      for (int k = 0; k < n; k++) product(i, j) += a(i, k) * complements(j, k);
+    }
+  }
+  EXPECT_TRUE(product == S21Matrix(n, n));
+}
+
 TEST(OperatorEqMatrix, test1) {
   S21Matrix a(7, 7);
   S21Matrix b(7, 7);
@@ -714,8 +1000,9 @@ TEST(OperatorMinus, test1) {
   c = a - b;
   result.SetMatrix(5.7);
 
-  bool compare = a.EqMatrix(result);
+  bool compare = c.EqMatrix(result);
   EXPECT_EQ(compare, true);
+  EXPECT_EQ(a(0, 0), 9);
 }
 
 TEST(OperatorPlusEquals, test1) {
@@ -771,7 +1058,11 @@ TEST(OperatorMulNumber, test1) {
   res(3, 1) = 105;
   res(3, 2) = 112;
 
-  a * 7;
+  S21Matrix unchanged(a);
+  S21Matrix product = a * 7;
+  EXPECT_TRUE(a.EqMatrix(unchanged));
+  a = 7 * a;
+  EXPECT_TRUE(product.EqMatrix(res));
   bool compare = a.EqMatrix(res);
   EXPECT_EQ(compare, true);
 }
@@ -794,6 +1085,113 @@ TEST(OperatorMulMatrix, test2) {
   ASSERT_TRUE(C == result);
 }
 
+TEST(Expression, test1_fused_no_mutation) {
+  S21Matrix a(3, 4), b(3, 4), d(3, 4);
+  a.SetMatrixIncremented(1);
+  b.SetMatrix(2);
+  d.SetMatrix(0.5);
+  S21Matrix a_copy(a), b_copy(b);
+  S21Matrix c = a + b * 2.0 - d;
+  EXPECT_TRUE(a == a_copy);
+  EXPECT_TRUE(b == b_copy);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) EXPECT_EQ(c(i, j), a(i, j) + 3.5);
+  }
+  EXPECT_THROW(S21Matrix(a + S21Matrix(4, 3)), std::logic_error);
+}
+
+TEST(Expression, test2_aliasing) {
+  S21Matrix a(2, 3);
+  a.SetMatrixIncremented(1);
+  a = a + a * 2.0;
+  EXPECT_EQ(a(1, 2), 18);
+  a = a.Transpose() * 1.0;
+  EXPECT_EQ(a.GetRows(), 3);
+  EXPECT_EQ(a.GetCols(), 2);
+  EXPECT_EQ(a(2, 1), 18);
+  EXPECT_EQ(a(0, 1), 12);
+  S21Matrix b(2, 2);
+  b.SetMatrixIncremented(1);
+  a = a * b;
+  EXPECT_EQ(a(2, 1), 9 * 2 + 18 * 4);
+}
+
+TEST(Expression, test3_gemm_update) {
+  S21Matrix a(4, 3), b(3, 5), c(4, 5);
+  a.SetMatrixIncremented(1);
+  b.SetMatrixIncremented(-7);
+  c.SetMatrixIncremented(0.5);
+  S21Matrix product = a * b;
+  S21Matrix expected(4, 5);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 5; j++) {
+      expected(i, j) = 2.0 * product(i, j) + 0.5 * c(i, j);
+    }
+  }
+  S21Matrix other = 0.5 * c + 2.0 * a * b;
+  EXPECT_TRUE(other == expected);
+  c = 2.0 * a * b + 0.5 * c;
+  EXPECT_TRUE(c == expected);
+  S21Matrix square(4, 4);
+  square.SetMatrixIncremented(1);
+  S21Matrix alias(square);
+  alias = square * alias + alias;
+  EXPECT_TRUE(alias == square * square + square);
+}
+
+TEST(Expression, test4_transposed_products) {
+  // Sizes past one GEMM block, and n <= 4 for the dot-product path.
+  auto filled = [](int rows, int cols, int seed) {
+    S21Matrix m(rows, cols);
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) m(i, j) = (i * 7 + j * seed) % 11 - 5;
+    }
+    return m;
+  };
+  auto product = [](const S21Matrix& x, const S21Matrix& y) {
+    S21Matrix z(x.GetRows(), y.GetCols());
+    for (int i = 0; i < x.GetRows(); i++) {
+      for (int j = 0; j < y.GetCols(); j++) {
+        for (int p = 0; p < x.GetCols(); p++) {
+          z(i, j) += x.At(i, p) * y.At(p, j);
+        }
+      }
+    }
+    return z;
+  };
+  S21Matrix a = filled(300, 130, 3), b = filled(300, 90, 5);
+  S21Matrix c = filled(90, 130, 2), v = filled(300, 3, 4);
+  S21Matrix at(a.Transpose()), bt(b.Transpose()), ct(c.Transpose());
+  EXPECT_TRUE(S21Matrix(a.Transpose() * b) == product(at, b));
+  EXPECT_TRUE(S21Matrix(a * c.Transpose()) == product(a, ct));
+  EXPECT_TRUE(S21Matrix(c.Transpose() * b.Transpose()) == product(ct, bt));
+  EXPECT_TRUE(S21Matrix(a.Transpose() * v) == product(at, v));
+  S21Matrix scaled = 2.0 * (a.Transpose() * 0.5).Transpose().Transpose() * b;
+  EXPECT_TRUE(scaled == product(at, b));
+  S21Matrix block = a.Block(10, 20, 40, 30).Transpose() * b.Block(10, 0, 40, 5);
+  EXPECT_TRUE(block == product(S21Matrix(at.Block(20, 10, 30, 40)),
+                               S21Matrix(b.Block(10, 0, 40, 5))));
+  EXPECT_THROW(S21Matrix(a.Transpose() * c), std::out_of_range);
+}
+
+TEST(Expression, test5_mul_matrix_transposed) {
+  S21Matrix a(5, 3), b(4, 3);
+  a.SetMatrixIncremented(1);
+  b.SetMatrixIncremented(-2);
+  S21Matrix expected = a * S21Matrix(b.Transpose());
+  S21Matrix c(a);
+  c.MulMatrix(b.Transpose());
+  EXPECT_TRUE(c == expected);
+  c = a;
+  c *= b.Transpose();
+  EXPECT_TRUE(c == expected);
+  // Aliased: the Gram matrix of a with itself.
+  S21Matrix gram = S21Matrix(a.Transpose()) * a;
+  a = a.Transpose() * a;
+  EXPECT_TRUE(a == gram);
+  EXPECT_THROW(c.MulMatrix(b.Transpose()), std::out_of_range);
+}
+
 TEST(OperatorMulEqualsNum, Test1) {
   S21Matrix a(5, 5);
   a.SetMatrixIncremented(7);
@@ -878,6 +1276,1099 @@ TEST(OperatorMulEqualsOther, test1) {
   EXPECT_EQ(compare, true);
 }
 
+TEST(Factorization, test1_lu_solve) {
+  S21Matrix a(3, 3);
+  a(0, 0) = 0;
+  a(0, 1) = 2;
+  a(0, 2) = 1;
+  a(1, 0) = 1;
+  a(1, 1) = 1;
+  a(1, 2) = 1;
+  a(2, 0) = 4;
+  a(2, 1) = -1;
+  a(2, 2) = 3;
+  S21LU lu(a);
+  EXPECT_FALSE(lu.IsSingular());
+  // Columns of b are A * (1, 2, 3) and A * (-1, 0, 2).
+  S21Matrix b(3, 2);
+  b(0, 0) = 7;
+  b(1, 0) = 6;
+  b(2, 0) = 11;
+  b(0, 1) = 2;
+  b(1, 1) = 1;
+  b(2, 1) = 2;
+  S21Matrix x = lu.Solve(b);
+  S21Matrix expected(3, 2);
+  expected(0, 0) = 1;
+  expected(1, 0) = 2;
+  expected(2, 0) = 3;
+  expected(0, 1) = -1;
+  expected(1, 1) = 0;
+  expected(2, 1) = 2;
+  EXPECT_TRUE(x == expected);
+  std::vector<double> single = lu.Solve(std::vector<double>{7, 6, 11});
+  EXPECT_NEAR(single[2], 3, 1e-12);
+  EXPECT_NEAR(lu.Determinant(), a.Determinant(), 1e-12);
+  EXPECT_TRUE(lu.Inverse() == a.InverseMatrix());
+  EXPECT_THROW(lu.Solve(S21Matrix(2, 1)), std::logic_error);
+}
+
+TEST(Factorization, test2_lu_singular) {
+  S21Matrix a(4, 4);
+  a.SetMatrixIncremented(1);
+  for (int i = 0; i < 4; i++) a(i, 2) = 0;
+  S21LU lu(a);
+  EXPECT_TRUE(lu.IsSingular());
+  EXPECT_EQ(lu.Determinant(), 0);
+  EXPECT_THROW(lu.Inverse(), std::out_of_range);
+  EXPECT_THROW(S21LU(S21Matrix(2, 3)), std::logic_error);
+}
+
+TEST(Factorization, test3_cholesky) {
+  // A = B^T * B + n * I is symmetric positive definite.
+  const int n = 9;
+  S21Matrix b(n, n);
+  b.SetMatrixIncremented(-40);
+  S21Matrix a(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      for (int k = 0; k < n; k++) a(i, j) += b(k, i) * b(k, j);
+    }
+    a(i, i) += n;
+  }
+  S21Cholesky cholesky(a);
+  S21Matrix x(n, 3);
+  x.SetMatrixIncremented(1);
+  S21Matrix rhs = a * x;
+  EXPECT_TRUE(cholesky.Solve(rhs) == x);
+  EXPECT_NEAR(cholesky.Determinant() / a.Determinant(), 1, 1e-9);
+  EXPECT_TRUE(a * cholesky.Inverse() == S21LU(a).Solve(a));
+  S21Matrix indefinite(2, 2);
+  indefinite(0, 0) = 1;
+  indefinite(1, 0) = 2;
+  indefinite(1, 1) = 1;
+  EXPECT_THROW(S21Cholesky{indefinite}, std::logic_error);
+}
+
+TEST(Factorization, test4_qr_least_squares) {
+  // Fit y = 2 + 3t exactly, then y = 2.6 + 2.6t with a residual.
+  S21Matrix a(4, 2);
+  for (int i = 0; i < 4; i++) {
+    a(i, 0) = 1;
+    a(i, 1) = i;
+  }
+  S21QR qr(a);
+  EXPECT_FALSE(qr.IsRankDeficient());
+  std::vector<double> exact = qr.Solve(std::vector<double>{2, 5, 8, 11});
+  EXPECT_NEAR(exact[0], 2, 1e-12);
+  EXPECT_NEAR(exact[1], 3, 1e-12);
+  std::vector<double> fit = qr.Solve(std::vector<double>{3, 4, 9, 10});
+  EXPECT_NEAR(fit[0], 2.6, 1e-12);
+  EXPECT_NEAR(fit[1], 2.6, 1e-12);
+  EXPECT_THROW(qr.Determinant(), std::logic_error);
+  EXPECT_THROW(S21QR(S21Matrix(2, 3)), std::logic_error);
+}
+
+TEST(Factorization, test5_qr_square) {
+  S21Matrix a(5, 5);
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) {
+      a(i, j) = (i * 4 + j * 7) % 9 - 4 + 3 * (i == j);
+    }
+  }
+  S21QR qr(a);
+  EXPECT_NEAR(qr.Determinant(), a.Determinant(), 1e-9);
+  EXPECT_TRUE(qr.Inverse() == a.InverseMatrix());
+  S21Matrix rank_one(3, 3);
+  rank_one.SetMatrix(2);
+  EXPECT_TRUE(S21QR(rank_one).IsRankDeficient());
+  // Rank 2 with no exact zero left on the diagonal of R.
+  S21Matrix singular(4, 4);
+  singular.SetMatrixIncremented(1);
+  S21QR noisy(singular);
+  EXPECT_TRUE(noisy.IsRankDeficient());
+  EXPECT_EQ(noisy.Determinant(), 0);
+  EXPECT_THROW(noisy.Inverse(), std::out_of_range);
+  EXPECT_THROW(noisy.Solve(std::vector<double>(4, 1.0)), std::out_of_range);
+}
+
+TEST(Factorization, test6_mixed_refinement) {
+  // Diagonally dominant, so float LU plus a few refinement steps reach
+  // double accuracy.
+  int n = 200;
+  S21Matrix a(n, n), b(n, 2);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = std::sin(i * 0.37 + j * 1.3);
+    a(i, i) += n;
+    b(i, 0) = std::cos(i * 0.1);
+    b(i, 1) = i % 7 - 3.0;
+  }
+  S21MixedLU mixed(a);
+  EXPECT_FALSE(mixed.UsesFallback());
+  S21RefinementInfo info;
+  S21Matrix x = mixed.Solve(b, &info);
+  EXPECT_FALSE(info.fallback);
+  EXPECT_GE(info.iterations, 1);
+  EXPECT_LE(info.iterations, 5);
+  EXPECT_LE(info.residual, std::sqrt(n) * DBL_EPSILON);
+  S21Matrix expected = S21LU(a).Solve(b);
+  for (int i = 0; i < n; i++) {
+    EXPECT_NEAR(x(i, 0), expected(i, 0), 1e-13);
+    EXPECT_NEAR(x(i, 1), expected(i, 1), 1e-13);
+  }
+  std::vector<double> single = mixed.Solve(std::vector<double>(n, 1.0));
+  EXPECT_EQ(static_cast<int>(single.size()), n);
+  EXPECT_THROW(mixed.Solve(S21Matrix(3, 1)), std::logic_error);
+  EXPECT_THROW(S21MixedLU(S21Matrix(2, 3)), std::logic_error);
+}
+
+TEST(Factorization, test7_mixed_fallback) {
+  // The 6 x 6 Hilbert matrix has condition number 1.5e7, at the edge of
+  // what float can refine: three iterations are not enough and the solve
+  // falls back to double.
+  auto hilbert = [](int n) {
+    S21Matrix h(n, n);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) h(i, j) = 1.0 / (i + j + 1);
+    }
+    return h;
+  };
+  S21Matrix h = hilbert(6), b(6, 1);
+  b.SetMatrix(1.0);
+  S21RefinementInfo info;
+  S21MixedLU refined(h, 0.0, 3);
+  EXPECT_FALSE(refined.UsesFallback());
+  S21Matrix x = refined.Solve(b, &info);
+  EXPECT_TRUE(info.fallback);
+  EXPECT_EQ(info.iterations, 3);
+  EXPECT_TRUE(x == S21LU(h).Solve(b));
+  // The double factorization is kept, so the next solve starts from it.
+  EXPECT_TRUE(refined.UsesFallback());
+  EXPECT_TRUE(refined.Solve(b, &info) == x);
+  EXPECT_TRUE(info.fallback);
+  EXPECT_EQ(info.iterations, 0);
+  // At 10 x 10 (condition number 1.6e13) the float factorization is already
+  // numerically singular.
+  S21MixedLU ill_conditioned(hilbert(10));
+  EXPECT_TRUE(ill_conditioned.UsesFallback());
+  // Out of float range: factored in double from the start.
+  S21Matrix big(2, 2);
+  big(0, 0) = 1e300;
+  big(1, 1) = 1.0;
+  S21MixedLU mixed(big);
+  EXPECT_TRUE(mixed.UsesFallback());
+  std::vector<double> y = mixed.Solve(std::vector<double>{1e300, 2.0}, &info);
+  EXPECT_TRUE(info.fallback);
+  EXPECT_EQ(info.iterations, 0);
+  EXPECT_DOUBLE_EQ(y[0], 1.0);
+  EXPECT_DOUBLE_EQ(y[1], 2.0);
+  S21Matrix singular(3, 3);
+  EXPECT_THROW(S21MixedLU(singular).Solve(b.Block(0, 0, 3, 1)),
+               std::out_of_range);
+}
+
+TEST(Factorization, test8_lu_solve_transposed) {
+  // n spans several panels of the blocked triangular solves.
+  int n = 150;
+  S21Matrix a(n, n), x(n, 2);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) a(i, j) = ((i * 13 + j * 7) % 17 - 8.0) / n;
+    // A permuted dominant diagonal, so the factorization has to pivot.
+    a(i, (i * 7) % n) += 10.0;
+    x(i, 0) = i % 7 - 3;
+    x(i, 1) = 1.0 / (i + 1);
+  }
+  S21Matrix b = a.Transpose() * x;
+  S21LU lu(a);
+  S21Matrix solved = lu.SolveTransposed(b);
+  for (int i = 0; i < n; i++) {
+    EXPECT_NEAR(solved(i, 0), x(i, 0), 1e-9);
+    EXPECT_NEAR(solved(i, 1), x(i, 1), 1e-9);
+  }
+  std::vector<double> column(n);
+  for (int i = 0; i < n; i++) column[i] = b(i, 0);
+  std::vector<double> single = lu.SolveTransposed(column);
+  EXPECT_NEAR(single[n - 1], x(n - 1, 0), 1e-9);
+  EXPECT_THROW(lu.SolveTransposed(S21Matrix(2, 1)), std::logic_error);
+}
+
+TEST(View, test1_row_col_block) {
+  S21Matrix a(4, 5);
+  a.SetMatrixIncremented(0);
+  S21MatrixView block = a.Block(1, 2, 3, 2);
+  EXPECT_EQ(block.GetRows(), 3);
+  EXPECT_EQ(block.GetCols(), 2);
+  EXPECT_EQ(block(0, 0), 7);
+  EXPECT_EQ(block.Row(2)(0, 1), 18);
+  EXPECT_EQ(a.Col(4)(3, 0), 19);
+  block(2, 1) = -1;
+  EXPECT_EQ(a(3, 3), -1);
+  a.Row(0).Fill(2);
+  EXPECT_EQ(a(0, 4), 2);
+  EXPECT_EQ(a(1, 0), 5);
+  EXPECT_THROW(a.Block(2, 2, 3, 1), std::out_of_range);
+  EXPECT_THROW(block(3, 0), std::out_of_range);
+  EXPECT_THROW(a.Row(4), std::out_of_range);
+  const S21Matrix& constant = a;
+  S21MinorView minor = constant.Minor(1, 2);
+  EXPECT_EQ(minor.GetRows(), 3);
+  EXPECT_EQ(minor.At(1, 2), 13);
+  EXPECT_TRUE(S21Matrix(minor) == S21Matrix(a.Minor(1, 2)));
+}
+
+TEST(View, test2_arithmetic_and_gemm) {
+  S21Matrix a(9, 9), b(9, 9);
+  a.SetMatrixIncremented(-40);
+  b.SetMatrixIncremented(3);
+  S21Matrix a_block(a.Block(2, 1, 4, 5));
+  S21Matrix b_block(b.Block(0, 3, 5, 6));
+  S21Matrix expected = a_block * b_block;
+  S21Matrix product = a.Block(2, 1, 4, 5) * b.Block(0, 3, 5, 6);
+  EXPECT_TRUE(product == expected);
+  a_block.MulMatrix(b.Block(0, 3, 5, 6));
+  EXPECT_TRUE(a_block == expected);
+
+  S21Matrix c(9, 9);
+  c.Block(5, 3, 4, 6).Assign(a.Block(2, 1, 4, 5) * b.Block(0, 3, 5, 6));
+  EXPECT_TRUE(S21Matrix(c.Block(5, 3, 4, 6)) == expected);
+  EXPECT_EQ(c(4, 3), 0);
+  EXPECT_EQ(c(5, 2), 0);
+
+  S21Matrix sum(a.Block(0, 0, 3, 3) + 2.0 * b.Block(6, 6, 3, 3));
+  EXPECT_EQ(sum(1, 2), a(1, 2) + 2.0 * b(7, 8));
+  // The blocks overlap, so the right-hand side must be read before writing.
+  S21Matrix copy(a);
+  a.Block(0, 0, 3, 3) += a.Block(1, 1, 3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      EXPECT_EQ(a(i, j), copy(i, j) + copy(i + 1, j + 1));
+    }
+  }
+  a.Block(1, 1, 3, 3).Assign(a.Block(0, 0, 3, 3).Transpose());
+  EXPECT_EQ(a(1, 2), copy(1, 0) + copy(2, 1));
+}
+
+TEST(View, test3_factorizations) {
+  S21Matrix a(6, 6);
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 6; j++) {
+      a(i, j) = (i * 5 + j * 3) % 7 - 3 + 9 * (i == j);
+    }
+  }
+  S21Matrix inner(a.Block(1, 1, 4, 4));
+  S21LU lu(a.Block(1, 1, 4, 4));
+  EXPECT_NEAR(lu.Determinant(), inner.Determinant(), 1e-9);
+  S21Matrix x = lu.Solve(a.Block(1, 0, 4, 1));
+  S21Matrix residual = inner * x - S21Matrix(a.Block(1, 0, 4, 1));
+  EXPECT_TRUE(residual == S21Matrix(4, 1));
+  S21QR qr(a.Block(0, 0, 6, 3));
+  EXPECT_FALSE(qr.IsRankDeficient());
+  S21Matrix complements = a.CalcComplements();
+  EXPECT_NEAR(complements(2, 3),
+              -S21Matrix(a.Minor(2, 3)).Determinant(), 1e-9);
+}
+
+TEST(FixedMatrix, test1_arithmetic) {
+  constexpr S21FixedMatrix<2, 3> a(1, 2, 3, 4, 5, 6);
+  constexpr S21FixedMatrix<3, 2> b = a.Transpose();
+  static_assert(b.At(2, 1) == 6, "transpose is evaluated at compile time");
+  constexpr S21FixedMatrix<2, 2> product = a * b;
+  static_assert(product.At(0, 1) == 32, "product is evaluated at compile time");
+  S21FixedMatrix<2, 3> c = a + a * 2.0 - a;
+  EXPECT_EQ(c(1, 2), 12);
+  c *= 0.5;
+  EXPECT_TRUE(c == a);
+  EXPECT_THROW(c(2, 0), std::out_of_range);
+  S21FixedMatrix<2, 2> square(1, 2, 3, 4);
+  square *= S21FixedMatrix<2, 2>::Identity() * 3.0;
+  EXPECT_EQ(square(1, 0), 9);
+}
+
+TEST(FixedMatrix, test2_matches_dynamic) {
+  constexpr S21FixedMatrix<3, 3> small(2, -1, 0, -1, 2, -1, 0, -1, 2);
+  static_assert(small.Determinant() == 4, "determinant is constexpr");
+  S21FixedMatrix<4, 4> a(4, 1, 2, 0, 1, 5, 1, 2, 2, 1, 6, 1, 0, 2, 1, 7);
+  S21FixedMatrix<5, 5> b;
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) {
+      b(i, j) = (i * 3 + j * 7) % 5 - 2 + 6 * (i == j);
+    }
+  }
+  S21Matrix dynamic_a = a.ToMatrix();
+  S21Matrix dynamic_b = b.ToMatrix();
+  EXPECT_NEAR(a.Determinant(), dynamic_a.Determinant(), 1e-9);
+  EXPECT_NEAR(b.Determinant(), dynamic_b.Determinant(), 1e-9);
+  EXPECT_TRUE(dynamic_a.CalcComplements() == a.CalcComplements().View());
+  EXPECT_TRUE(dynamic_b.CalcComplements() == b.CalcComplements().View());
+  EXPECT_TRUE(dynamic_a.InverseMatrix() == a.InverseMatrix().View());
+  EXPECT_TRUE(dynamic_b.InverseMatrix() == b.InverseMatrix().View());
+  EXPECT_TRUE(a * a.InverseMatrix() == (S21FixedMatrix<4, 4>::Identity()));
+  S21FixedMatrix<2, 2> singular(1, 2, 2, 4);
+  EXPECT_THROW(singular.InverseMatrix(), std::out_of_range);
+  // Singular, but elimination leaves rounding noise instead of a zero pivot.
+  S21FixedMatrix<5, 5> noisy;
+  for (int i = 0; i < 25; i++) noisy(i / 5, i % 5) = i + 1;
+  EXPECT_EQ(noisy.Determinant(), 0.0);
+  EXPECT_EQ(noisy.ToMatrix().Determinant(), 0.0);
+  EXPECT_THROW(noisy.InverseMatrix(), std::out_of_range);
+  S21FixedMatrix<1, 1> one(4);
+  EXPECT_EQ(one.InverseMatrix()(0, 0), 0.25);
+}
+
+TEST(FixedMatrix, test3_conversions) {
+  S21Matrix m(3, 4);
+  m.SetMatrixIncremented(1);
+  S21FixedMatrix<3, 4> fixed(m);
+  EXPECT_EQ(fixed(2, 3), 12);
+  S21FixedMatrix<2, 2> block(m.Block(1, 1, 2, 2));
+  EXPECT_EQ(block(1, 0), 10);
+  EXPECT_THROW((S21FixedMatrix<4, 3>(m)), std::logic_error);
+  fixed.View().Row(0).Fill(0);
+  S21Matrix product = fixed.View() * m.Transpose();
+  EXPECT_EQ(product(0, 0), 0);
+  EXPECT_EQ(product(1, 1), 25 + 36 + 49 + 64);
+  EXPECT_TRUE(fixed.ToMatrix() == fixed.View());
+}
+
+TEST(MatrixBatch, test1_matches_per_member) {
+  for (int n = 1; n <= 5; n++) {
+    S21MatrixBatch a(19, n, n);
+    S21MatrixBatch b(19, n, n);
+    for (int k = 0; k < a.GetCount(); k++) {
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+          a(k, i, j) = (k * 7 + i * 3 + j * 5) % 11 - 5 + 12 * (i == j);
+          b(k, i, j) = (k + i * j) % 4 - 1.5;
+        }
+      }
+    }
+    S21MatrixBatch product = a;
+    product.MulMatrix(b);
+    S21MatrixBatch sum = a;
+    sum.SumMatrix(b);
+    std::vector<double> det = a.Determinant();
+    S21MatrixBatch inverse = a.InverseMatrix();
+    for (int k = 0; k < a.GetCount(); k++) {
+      S21Matrix member = a.Get(k);
+      EXPECT_NEAR(det[k], member.Determinant(), 1e-9 * std::abs(det[k]));
+      EXPECT_TRUE(inverse.Get(k) == member.InverseMatrix());
+      EXPECT_TRUE(sum.Get(k) == member + b.Get(k));
+      member.MulMatrix(b.Get(k));
+      EXPECT_TRUE(product.Get(k) == member);
+    }
+  }
+}
+
+TEST(MatrixBatch, test2_rectangular_and_transpose) {
+  S21MatrixBatch a(10, 2, 3);
+  S21MatrixBatch b(10, 3, 4);
+  S21Matrix m(3, 4);
+  m.SetMatrixIncremented(1);
+  for (int k = 0; k < 10; k++) {
+    a.Set(k, S21Matrix(m.Block(0, 0, 2, 3) * k));
+    b.Set(k, m);
+  }
+  S21MatrixBatch t = a.Transpose();
+  EXPECT_EQ(t.GetRows(), 3);
+  EXPECT_EQ(t(9, 2, 1), 63);
+  a.MulMatrix(b);
+  EXPECT_EQ(a.GetCols(), 4);
+  EXPECT_TRUE(a.Get(3) == m.Block(0, 0, 2, 3) * m * 3.0);
+  a.MulNumber(0.5);
+  EXPECT_EQ(a(2, 0, 0), 38);
+  EXPECT_THROW(a.MulMatrix(b), std::out_of_range);
+  EXPECT_THROW(a.SumMatrix(b), std::logic_error);
+  EXPECT_THROW(a.Set(0, m), std::logic_error);
+  EXPECT_THROW(a(10, 0, 0), std::out_of_range);
+  EXPECT_THROW(S21MatrixBatch(0, 2, 2), std::logic_error);
+}
+
+TEST(MatrixBatch, test3_singular_member) {
+  S21MatrixBatch a(9, 4, 4);
+  for (int k = 0; k < 9; k++) {
+    for (int i = 0; i < 4; i++) a(k, i, i) = k + 1;
+  }
+  EXPECT_EQ(a.Determinant()[8], 6561);
+  EXPECT_NEAR(a.InverseMatrix()(8, 3, 3), 1.0 / 9, 1e-15);
+  a(4, 3, 3) = 0;
+  EXPECT_EQ(a.Determinant()[4], 0);
+  EXPECT_THROW(a.InverseMatrix(), std::out_of_range);
+  EXPECT_THROW(S21MatrixBatch(3, 2, 3).Determinant(), std::logic_error);
+  // Rank 2, with pivots of rounding noise rather than exact zeros.
+  for (int n : {4, 5}) {
+    S21MatrixBatch b(9, n, n);
+    for (int k = 0; k < 9; k++) {
+      for (int i = 0; i < n; i++) b(k, i, i) = k + 1;
+    }
+    S21Matrix singular(n, n);
+    singular.SetMatrixIncremented(1);
+    b.Set(6, singular);
+    std::vector<double> det = b.Determinant();
+    EXPECT_EQ(det[6], 0) << n;
+    EXPECT_EQ(det[7], std::pow(8, n)) << n;
+    EXPECT_THROW(b.InverseMatrix(), std::out_of_range) << n;
+  }
+}
+
+TEST(SparseMatrix, test1_construction) {
+  S21SparseMatrix a(3, 4, {{2, 1, 5.0}, {0, 3, 1.0}, {2, 1, -2.0},
+                           {1, 0, 4.0}, {0, 0, 2.0}, {1, 2, 1.0},
+                           {1, 2, -1.0}});
+  EXPECT_EQ(a.NonZeros(), 4);
+  EXPECT_EQ(a(2, 1), 3.0);
+  EXPECT_EQ(a(1, 2), 0.0);
+  EXPECT_EQ(a.Indices(), (std::vector<int>{0, 3, 0, 1}));
+  S21Matrix dense = a.ToDense();
+  dense(1, 1) = 1e-12;
+  S21SparseMatrix dropped(dense, 1e-9);
+  EXPECT_EQ(dropped.NonZeros(), 4);
+  EXPECT_TRUE(dropped.ToDense() == a.ToDense());
+  EXPECT_EQ(S21SparseMatrix(dense).NonZeros(), 5);
+  S21SparseMatrix csc = a.ToCsc();
+  EXPECT_EQ(csc.Format(), S21SparseFormat::kCsc);
+  EXPECT_EQ(csc.Offsets(), (std::vector<int>{0, 2, 3, 3, 4}));
+  EXPECT_TRUE(csc.ToDense() == a.ToDense());
+  EXPECT_EQ(csc(2, 1), 3.0);
+  EXPECT_THROW(S21SparseMatrix(2, 2, {{2, 0, 1.0}}), std::out_of_range);
+  EXPECT_THROW(a(3, 0), std::out_of_range);
+}
+
+TEST(SparseMatrix, test2_products_match_dense) {
+  S21Matrix dense(300, 200);
+  for (int i = 0; i < 300; i++) {
+    for (int j = (i * 7) % 13; j < 200; j += 13) dense(i, j) = i - j * 0.5;
+  }
+  S21Matrix b(200, 9);
+  b.SetMatrixIncremented(-100);
+  std::vector<double> x(200);
+  for (int j = 0; j < 200; j++) x[j] = b(j, 0);
+  S21SparseMatrix a(dense);
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  int threads = pool.GetThreads();
+  pool.SetThreads(4);
+  S21Matrix expected = dense * b;
+  EXPECT_TRUE(a * b == expected);
+  EXPECT_TRUE(a.ToCsc() * b == expected);
+  std::vector<double> y = a * x;
+  std::vector<double> y_csc = a.ToCsc() * x;
+  for (int i = 0; i < 300; i++) {
+    EXPECT_NEAR(y[i], expected(i, 0), 1e-9);
+    EXPECT_NEAR(y_csc[i], expected(i, 0), 1e-9);
+  }
+  pool.SetThreads(threads);
+  EXPECT_THROW(a * std::vector<double>(3), std::out_of_range);
+  EXPECT_THROW(a * S21Matrix(300, 2), std::out_of_range);
+}
+
+TEST(SparseMatrix, test4_threaded_product) {
+  // Enough flops to split the rows across workers; run it under make tsan.
+  int n = 2000;
+  std::vector<S21Triplet> triplets;
+  for (int i = 0; i < n; i++) {
+    for (int k = 0; k < 20; k++) {
+      triplets.push_back({i, (i * 31 + k * 97) % n, 1.0 + k});
+    }
+  }
+  S21SparseMatrix a(n, n, triplets);
+  S21Matrix b(n, 64);
+  b.SetMatrixIncremented(-1000);
+  int threads = S21GetNumThreads();
+  S21SetNumThreads(1);
+  S21Matrix serial = a * b;
+  S21SetNumThreads(4);
+  S21Matrix parallel = a * b;
+  S21SetNumThreads(threads);
+  EXPECT_TRUE(parallel == serial);
+  EXPECT_TRUE(serial == a.ToDense() * b);
+}
+
+TEST(SparseMatrix, test3_sum_and_transpose) {
+  S21SparseMatrix a(3, 3, {{0, 0, 1.0}, {1, 2, 2.0}, {2, 1, 3.0}});
+  S21SparseMatrix b(3, 3, {{0, 0, -1.0}, {1, 1, 4.0}, {2, 1, 1.0}});
+  S21SparseMatrix sum = a + b.ToCsc();
+  EXPECT_EQ(sum.NonZeros(), 3);
+  EXPECT_TRUE(sum.ToDense() == a.ToDense() + b.ToDense());
+  S21SparseMatrix t = a.Transpose();
+  EXPECT_EQ(t.Format(), S21SparseFormat::kCsc);
+  EXPECT_EQ(t(1, 2), 3.0);
+  EXPECT_TRUE(t.ToDense() == a.ToDense().Transpose());
+  EXPECT_TRUE(t.ToCsr().Transpose().ToDense() == a.ToDense());
+  EXPECT_THROW(a + S21SparseMatrix(3, 2), std::logic_error);
+}
+
+TEST(MatrixFile, test1_save_load) {
+  S21Matrix a(13, 10);
+  a.SetMatrixIncremented(-20.5);
+  a.Save("s21_test_matrix.bin");
+  S21Matrix loaded = S21Matrix::Load("s21_test_matrix.bin");
+  EXPECT_TRUE(loaded == a);
+  S21SaveMatrix(a.Block(2, 3, 4, 5), "s21_test_matrix.bin");
+  EXPECT_TRUE(S21Matrix::Load("s21_test_matrix.bin") == a.Block(2, 3, 4, 5));
+  // Flip one bit of the last element.
+  std::fstream file("s21_test_matrix.bin",
+                    std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(-1, std::ios::end);
+  file.put(0x01);
+  file.close();
+  EXPECT_THROW(S21Matrix::Load("s21_test_matrix.bin"), std::runtime_error);
+  std::ofstream("s21_test_matrix.bin") << "not a matrix";
+  EXPECT_THROW(S21Matrix::Load("s21_test_matrix.bin"), std::runtime_error);
+  EXPECT_THROW(S21MappedMatrix("s21_test_matrix.bin"), std::runtime_error);
+  std::remove("s21_test_matrix.bin");
+  EXPECT_THROW(S21Matrix::Load("s21_test_matrix.bin"), std::runtime_error);
+}
+
+TEST(MatrixFile, test2_mapped) {
+  S21Matrix a(40, 30);
+  a.SetMatrixIncremented(1);
+  a.Save("s21_test_matrix.bin");
+  {
+    S21MappedMatrix mapped("s21_test_matrix.bin");
+    EXPECT_EQ(mapped.GetRows(), 40);
+    EXPECT_TRUE(mapped.Verify());
+    EXPECT_TRUE(a == mapped.View());
+    EXPECT_TRUE(mapped.View() * a.Transpose() == a * a.Transpose());
+    EXPECT_THROW(mapped.MutableView(), std::logic_error);
+    S21MappedMatrix copy("s21_test_matrix.bin", S21MapMode::kCopyOnWrite);
+    copy.MutableView().Row(0).Fill(0);
+    EXPECT_EQ(copy.View()(0, 29), 0);
+    EXPECT_FALSE(copy.Verify());
+    EXPECT_EQ(mapped.View()(0, 29), 30);
+  }
+  EXPECT_TRUE(S21Matrix::Load("s21_test_matrix.bin") == a);
+  std::remove("s21_test_matrix.bin");
+}
+
+TEST(MatrixFile, test3_read_write_mapping) {
+  {
+    S21MappedMatrix created =
+        S21MappedMatrix::Create("s21_test_matrix.bin", 5, 9);
+    EXPECT_EQ(created.Mode(), S21MapMode::kReadWrite);
+    created.MutableView()(4, 8) = 7.5;
+  }
+  S21Matrix loaded = S21Matrix::Load("s21_test_matrix.bin");
+  EXPECT_EQ(loaded(4, 8), 7.5);
+  EXPECT_EQ(loaded(0, 0), 0);
+  std::remove("s21_test_matrix.bin");
+}
+
+TEST(OutOfCore, test1_multiply_files) {
+  S21Matrix a(37, 50);
+  S21Matrix b(50, 29);
+  a.SetMatrixIncremented(-900);
+  b.SetMatrixIncremented(3);
+  a.Save("s21_test_a.bin");
+  b.Save("s21_test_b.bin");
+  // Room for 8 x 8 tiles only, so every dimension is split.
+  int tile = S21MultiplyFiles("s21_test_a.bin", "s21_test_b.bin",
+                              "s21_test_c.bin", 5 * 8 * 8 * sizeof(double));
+  EXPECT_EQ(tile, 8);
+  EXPECT_TRUE(S21Matrix::Load("s21_test_c.bin") == a * b);
+  EXPECT_EQ(S21MultiplyFiles("s21_test_a.bin", "s21_test_b.bin",
+                             "s21_test_c.bin"),
+            56);
+  EXPECT_TRUE(S21MappedMatrix("s21_test_c.bin").Verify());
+  EXPECT_TRUE(S21Matrix::Load("s21_test_c.bin") == a * b);
+  EXPECT_THROW(S21MultiplyFiles("s21_test_b.bin", "s21_test_b.bin",
+                                "s21_test_c.bin"),
+               std::out_of_range);
+  std::remove("s21_test_a.bin");
+  std::remove("s21_test_b.bin");
+  std::remove("s21_test_c.bin");
+}
+
+TEST(Simd, test1_kernels_match_scalar) {
+  S21Matrix a(29, 70);
+  S21Matrix b(70, 33);
+  a.SetMatrixIncremented(-900);
+  b.SetMatrixIncremented(0.5);
+  S21ForceIsa(S21Isa::kScalar);
+  S21Matrix product = a * b;
+  S21Matrix sum(a);
+  sum += a;
+  sum *= 0.25;
+
+  for (S21Isa isa : {S21Isa::kSse2, S21Isa::kAvx2, S21Isa::kAvx512}) {
+    S21Isa selected = S21ForceIsa(isa);
+    EXPECT_LE(selected, isa);
+    EXPECT_EQ(S21GetKernels().isa, selected);
+    S21Matrix simd_product = a * b;
+    S21Matrix simd_sum(a);
+    simd_sum += a;
+    simd_sum *= 0.25;
+    EXPECT_TRUE(simd_product == product) << S21IsaName(selected);
+    EXPECT_TRUE(simd_sum == sum) << S21IsaName(selected);
+    simd_sum(28, 69) += 1.0;
+    EXPECT_FALSE(simd_sum == sum) << S21IsaName(selected);
+  }
+  S21ForceIsa(S21DetectIsa());
+}
+
+TEST(Simd, test2_fused_kernels_match_scalar) {
+  // 29 x 70 leaves a tail in every row for each vector width.
+  S21Matrix x(29, 70), y(29, 70), z(29, 70);
+  for (int i = 0; i < 29; i++) {
+    for (int j = 0; j < 70; j++) {
+      x(i, j) = (i * 7 + j) % 13 - 6.5;
+      y(i, j) = (i + j * 3) % 11 + 0.25;
+      z(i, j) = i - j;
+    }
+  }
+  for (S21Isa isa : {S21Isa::kScalar, S21Isa::kSse2, S21Isa::kAvx2,
+                     S21Isa::kAvx512}) {
+    const char* name = S21IsaName(S21ForceIsa(isa));
+    S21Matrix axpy(z), axpby(z), fma(z), product(z), quotient(z);
+    axpy.Axpy(-2.0, x);
+    axpby.Axpby(0.5, x, 3.0);
+    fma.FusedMulAdd(x, y);
+    product.HadamardProduct(x);
+    quotient.HadamardDivide(y);
+    for (int i = 0; i < 29; i++) {
+      for (int j = 0; j < 70; j++) {
+        double xv = x(i, j), yv = y(i, j), zv = z(i, j);
+        EXPECT_NEAR(axpy(i, j), zv - 2.0 * xv, 1e-12) << name;
+        EXPECT_NEAR(axpby(i, j), 0.5 * xv + 3.0 * zv, 1e-12) << name;
+        EXPECT_NEAR(fma(i, j), zv + xv * yv, 1e-12) << name;
+        EXPECT_NEAR(product(i, j), zv * xv, 1e-12) << name;
+        EXPECT_NEAR(quotient(i, j), zv / yv, 1e-12) << name;
+      }
+    }
+    // A single miss is found wherever it sits, including the tails.
+    std::vector<double> u(101, 1.0), v(101, 1.0);
+    EXPECT_TRUE(S21GetKernels().equal(101, u.data(), v.data(), 1e-7));
+    for (int miss : {0, 7, 31, 63, 100}) {
+      v[miss] = 1.1;
+      EXPECT_FALSE(S21GetKernels().equal(101, u.data(), v.data(), 1e-7))
+          << name << ' ' << miss;
+      v[miss] = 1.0;
+    }
+  }
+  S21ForceIsa(S21DetectIsa());
+}
+
+TEST(ThreadPool, test1_parallel_for) {
+  int saved = S21GetNumThreads();
+  S21SetNumThreads(4);
+  EXPECT_EQ(S21GetNumThreads(), 4);
+  std::vector<int> hits(100, 0);
+  S21ThreadPool::Instance().ParallelFor(100, [&](int i) { hits[i]++; });
+  for (int hit : hits) EXPECT_EQ(hit, 1);
+  EXPECT_THROW(S21ThreadPool::Instance().ParallelFor(
+                   10,
+                   [](int i) {
+                     if (i == 7) throw std::out_of_range("task failed\n");
+                   }),
+               std::out_of_range);
+  EXPECT_THROW(S21SetNumThreads(0), std::logic_error);
+  S21SetNumThreads(saved);
+}
+
+TEST(ThreadPool, test2_parallel_mul_matrix) {
+  int saved = S21GetNumThreads();
+  S21Matrix a(301, 190);
+  S21Matrix b(190, 257);
+  a.SetMatrixIncremented(-1000);
+  b.SetMatrixIncremented(0.25);
+  S21SetNumThreads(1);
+  S21Matrix serial = a * b;
+  S21SetNumThreads(5);
+  S21Matrix parallel = a * b;
+  EXPECT_TRUE(parallel == serial);
+  S21SetNumThreads(saved);
+}
+
+TEST(ThreadPool, test3_resize_then_run) {
+  // Restarted workers must not mistake the last batch for a new one.
+  int saved = S21GetNumThreads();
+  for (int round = 0; round < 50; round++) {
+    S21SetNumThreads(3 + round % 2);
+    std::vector<int> hits(8, 0);
+    S21ThreadPool::Instance().ParallelFor(8, [&](int i) { hits[i]++; });
+    for (int hit : hits) EXPECT_EQ(hit, 1);
+  }
+  S21SetNumThreads(saved);
+}
+
+namespace {
+
+int counted_blocks = 0;
+
+void* CountedAllocate(std::size_t bytes) {
+  counted_blocks++;
+  return ::operator new(bytes, std::align_val_t(kS21BufferAlignment));
+}
+
+void CountedDeallocate(void* p, std::size_t) {
+  counted_blocks--;
+  ::operator delete(p, std::align_val_t(kS21BufferAlignment));
+}
+
+}  // namespace
+
+TEST(Allocator, test1_pool_reuses_buffers) {
+  S21Matrix warm(7, 7);
+  S21ResetAllocationStats();
+  for (int i = 0; i < 100; i++) {
+    S21Matrix temporary(7, 7);
+    temporary(6, 6) = i;
+  }
+  S21AllocationStats stats = S21GetAllocationStats();
+  EXPECT_LE(stats.backing, 1u);
+  EXPECT_GE(stats.pooled, 99u);
+  EXPECT_EQ(stats.arena, 0u);
+}
+
+TEST(Allocator, test2_arena_scope) {
+  // Singular (two equal rows), so every complement goes through a copied
+  // 5 x 5 minor.
+  S21Matrix a(6, 6);
+  a.SetMatrixIncremented(1);
+  for (int i = 0; i < 6; i++) a(i, i) += i * i;
+  a.Row(5).Assign(a.Row(4));
+  S21Matrix expected = a.CalcComplements();
+  S21Matrix escaped;
+  S21ResetAllocationStats();
+  {
+    S21MatrixArena arena;
+    EXPECT_EQ(S21MatrixArena::Current(), &arena);
+    S21Matrix complements = a.CalcComplements();
+    EXPECT_TRUE(complements == expected);
+    escaped = complements * 2.0;
+  }
+  EXPECT_EQ(S21MatrixArena::Current(), nullptr);
+  S21AllocationStats stats = S21GetAllocationStats();
+  EXPECT_GT(stats.arena, 36u);
+  EXPECT_LE(stats.backing, 1u);
+  // The escaped result keeps its chunk alive until it goes away.
+  EXPECT_TRUE(escaped == expected * 2.0);
+}
+
+TEST(Allocator, test3_custom_backing_allocator) {
+  static const S21Allocator counted = {CountedAllocate, CountedDeallocate};
+  S21SetAllocator(&counted);
+  {
+    S21Matrix large(300, 300);
+    EXPECT_EQ(counted_blocks, 1);
+  }
+  EXPECT_EQ(counted_blocks, 0);
+  S21SetAllocator(nullptr);
+  S21Matrix large(300, 300);
+  EXPECT_EQ(counted_blocks, 0);
+}
+
+TEST(Elementwise, test1_fused_updates) {
+  S21Matrix x(3, 5), y(3, 5);
+  x.SetMatrix(2.0);
+  y.SetMatrix(std::nan(""));
+  // A zero beta overwrites, NaNs included.
+  y.Axpby(1.5, x, 0.0);
+  EXPECT_TRUE(y == x * 1.5);
+  // Row padding stays zero, even when infinities appear.
+  x.HadamardDivide(S21Matrix(3, 5));
+  y.Axpy(INFINITY, x);
+  EXPECT_EQ(x(2, 4), INFINITY);
+  const S21Matrix& padded = y;
+  EXPECT_EQ(padded.Data()[padded.Stride() - 1], 0.0);
+  EXPECT_THROW(y.Axpy(1.0, S21Matrix(5, 3)), std::logic_error);
+  EXPECT_THROW(y.FusedMulAdd(x, S21Matrix(3, 4)), std::logic_error);
+  EXPECT_THROW(y.HadamardProduct(S21Matrix(1, 5)), std::logic_error);
+  // x may be the destination itself.
+  S21Matrix z(3, 5);
+  z.SetMatrixIncremented(1.0);
+  S21Matrix expected = z * 2.0;
+  z.Axpby(2.0, z, 0.0);
+  EXPECT_TRUE(z == expected);
+  z.Axpby(1.0, z, 1.0);
+  EXPECT_TRUE(z == expected * 2.0);
+  z.Axpy(-1.0, z);
+  EXPECT_TRUE(z == S21Matrix(3, 5));
+}
+
+TEST(Elementwise, test2_threaded_bands) {
+  // 600 x 600 is above the threshold that splits the rows across threads.
+  S21Matrix x(600, 600), y(600, 600);
+  x.SetMatrixIncremented(-1000.0);
+  y.SetMatrixIncremented(0.5);
+  int saved = S21GetNumThreads();
+  S21SetNumThreads(1);
+  S21Matrix serial(y);
+  serial.FusedMulAdd(x, y);
+  serial.Axpby(0.25, x, -1.0);
+  serial += x;
+  S21SetNumThreads(4);
+  S21Matrix threaded(y);
+  threaded.FusedMulAdd(x, y);
+  threaded.Axpby(0.25, x, -1.0);
+  threaded += x;
+  S21SetNumThreads(saved);
+  EXPECT_TRUE(threaded == serial);
+  EXPECT_EQ(threaded(599, 599), serial(599, 599));
+}
+
+TEST(CopyOnWrite, test1_shares_until_written) {
+  S21SetCopyOnWrite(true);
+  S21Matrix a(40, 30);
+  a.SetMatrixIncremented(1);
+  S21Matrix b(a);
+  S21Matrix c(2, 2);
+  c = a;
+  const S21Matrix& read = b;
+  EXPECT_EQ(read(3, 4), 95);
+  EXPECT_EQ(b.At(3, 4), 95);
+  EXPECT_EQ(std::as_const(b).Data(), std::as_const(a).Data());
+  EXPECT_EQ(std::as_const(c).Data(), std::as_const(a).Data());
+  b(3, 4) = -1;
+  EXPECT_NE(std::as_const(b).Data(), std::as_const(a).Data());
+  EXPECT_EQ(a(3, 4), 95);
+  c += a;
+  EXPECT_EQ(c(3, 4), 190);
+  EXPECT_EQ(a(3, 4), 95);
+  // Copies that are factored or written through a view clone as well.
+  S21Matrix d(a);
+  d.Block(0, 0, 2, 2).Fill(0.0);
+  EXPECT_EQ(a(0, 0), 1);
+  S21Matrix e(5, 5);
+  e.SetMatrixIncremented(1);
+  for (int i = 0; i < 5; i++) e(i, i) += 10.0;
+  S21Matrix f(e);
+  double det = f.Determinant();
+  EXPECT_NEAR(f.Determinant(), det, 1e-9);
+  EXPECT_TRUE(f == e);
+  S21SetCopyOnWrite(false);
+}
+
+TEST(CopyOnWrite, test2_disabled_copies_eagerly) {
+  S21SetCopyOnWrite(true);
+  S21Matrix a(3, 3);
+  a.SetMatrixIncremented(1);
+  S21Matrix shared(a);
+  S21SetCopyOnWrite(false);
+  EXPECT_FALSE(S21GetCopyOnWrite());
+  S21Matrix b(a);
+  EXPECT_NE(std::as_const(b).Data(), std::as_const(a).Data());
+  // Assigning into a shared buffer must not write through to a.
+  S21Matrix other(3, 3);
+  shared = other;
+  EXPECT_EQ(shared(2, 2), 0);
+  EXPECT_EQ(a(2, 2), 9);
+}
+
+TEST(CopyOnWrite, test3_threads) {
+  S21SetCopyOnWrite(true);
+  S21Matrix a(64, 64);
+  a.SetMatrix(1.0);
+  std::vector<std::thread> threads;
+  std::vector<int> ok(4, 0);
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&a, &ok, t] {
+      bool same = true;
+      for (int i = 0; i < 200; i++) {
+        S21Matrix copy(a);
+        S21Matrix second = copy;
+        copy.MulNumber(t + 2.0);
+        same = same && copy(63, 63) == t + 2.0 && second(63, 63) == 1.0;
+      }
+      ok[t] = same;
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  S21SetCopyOnWrite(false);
+  for (int t = 0; t < 4; t++) EXPECT_TRUE(ok[t]);
+  EXPECT_EQ(a(63, 63), 1.0);
+}
+
+TEST(CopyOnWrite, test4_exposed_buffers_copy_eagerly) {
+  S21SetCopyOnWrite(true);
+  S21Matrix a(4, 4);
+  a.SetMatrixIncremented(1);
+  // A pointer taken before the copy must not write into the copy.
+  double* data = a.Data();
+  S21Matrix b(a);
+  EXPECT_NE(std::as_const(b).Data(), std::as_const(a).Data());
+  data[0] = -1;
+  EXPECT_EQ(b(0, 0), 1);
+  S21Matrix c(4, 4);
+  S21MatrixView view = c.Block(1, 1, 2, 2);
+  S21Matrix d(2, 2);
+  d = c;
+  view.Fill(5.0);
+  EXPECT_EQ(d(1, 1), 0);
+  EXPECT_EQ(c(1, 1), 5);
+  // Expression results are not exposed, and a new buffer is shareable.
+  S21Matrix e = a + a;
+  S21Matrix f(e);
+  EXPECT_EQ(std::as_const(f).Data(), std::as_const(e).Data());
+  a = S21Matrix(4, 4);
+  S21Matrix g(a);
+  EXPECT_EQ(std::as_const(g).Data(), std::as_const(a).Data());
+  // Neither are in-place updates from a view or the library's own results.
+  a += g.Block(0, 0, 4, 4);
+  a -= std::as_const(g).Block(0, 0, 4, 4);
+  S21Matrix h(a);
+  EXPECT_EQ(std::as_const(h).Data(), std::as_const(a).Data());
+  S21Matrix dense = S21SparseMatrix(4, 4, {{1, 2, 3.0}}).ToDense();
+  S21Matrix shared(dense);
+  EXPECT_EQ(std::as_const(shared).Data(), std::as_const(dense).Data());
+  S21SetCopyOnWrite(false);
+}
+
+TEST(Instrument, test1_counts_operations) {
+  S21Matrix a(4, 4), b(4, 4);
+  a.SetMatrixIncremented(1.0);
+  for (int i = 0; i < 4; i++) a(i, i) += 20.0;
+  S21ResetInstrumentation();
+  S21Matrix c(a);
+  c.MulMatrix(b);
+  c.SumMatrix(b);
+  a.InverseMatrix();
+  std::thread([&b] { S21Matrix d(b); }).join();
+  S21InstrumentSnapshot snapshot = S21GetInstrumentSnapshot();
+  const S21OpCounters& mul =
+      snapshot.ops[static_cast<int>(S21Op::kMulMatrix)];
+  if (kS21Instrumented) {
+    EXPECT_EQ(mul.calls, 1u);
+    EXPECT_EQ(mul.flops, 128u);
+    EXPECT_EQ(snapshot.ops[static_cast<int>(S21Op::kSumMatrix)].flops, 16u);
+    EXPECT_EQ(snapshot.ops[static_cast<int>(S21Op::kInverseMatrix)].calls,
+              1u);
+    // The copy made on the exited thread still counts.
+    EXPECT_GE(snapshot.ops[static_cast<int>(S21Op::kCopy)].calls, 2u);
+    EXPECT_GE(snapshot.bytes_copied, 2u * 4 * 8 * sizeof(double));
+    EXPECT_GE(snapshot.allocations, 3u);
+  } else {
+    EXPECT_EQ(mul.calls, 0u);
+    EXPECT_EQ(snapshot.allocations, 0u);
+    EXPECT_EQ(snapshot.bytes_copied, 0u);
+  }
+  S21ResetInstrumentation();
+  snapshot = S21GetInstrumentSnapshot();
+  EXPECT_EQ(snapshot.ops[static_cast<int>(S21Op::kMulMatrix)].calls, 0u);
+  EXPECT_EQ(snapshot.bytes_copied, 0u);
+}
+
+TEST(Instrument, test2_export_formats) {
+  S21InstrumentSnapshot snapshot = {};
+  snapshot.ops[static_cast<int>(S21Op::kMulMatrix)] = {3, 48, 1500000000};
+  snapshot.allocations = 2;
+  snapshot.bytes_allocated = 1024;
+  std::string json = S21InstrumentJson(snapshot);
+  EXPECT_NE(json.find("\"MulMatrix\": {\"calls\": 3, \"flops\": 48, "
+                      "\"seconds\": 1.5}"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"bytes_allocated\": 1024"), std::string::npos);
+  std::string text = S21InstrumentPrometheus(snapshot);
+  EXPECT_NE(text.find("# TYPE s21_matrix_op_calls_total counter\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_op_calls_total{op=\"MulMatrix\"} 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_op_seconds_total{op=\"MulMatrix\"} 1.5\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_allocations_total 2\n"), std::string::npos);
+  EXPECT_STREQ(S21OpName(S21Op::kCalcComplements), "CalcComplements");
+}
+
+TEST(BasicMatrix, test1_float) {
+  S21MatrixF a(4, 4), b(4, 4);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      a(i, j) = static_cast<float>(i * 4 + j + (i == j ? 20 : 0));
+      b(i, j) = static_cast<float>(i - j);
+    }
+  }
+  S21Matrix expected = S21MatrixCast<double>(a) * S21MatrixCast<double>(b);
+  EXPECT_TRUE(a * b == S21MatrixCast<float>(expected));
+  EXPECT_NEAR(a.Determinant(), S21MatrixCast<double>(a).Determinant(), 1.0);
+  S21MatrixF identity(4, 4);
+  for (int i = 0; i < 4; i++) identity(i, i) = 1.0f;
+  EXPECT_TRUE(a * a.InverseMatrix() == identity);
+  EXPECT_TRUE(a.Transpose().Transpose() == a);
+  EXPECT_EQ(a.Transpose()(0, 3), a(3, 0));
+  // The float tolerance is coarser than the double one.
+  S21MatrixF c = a;
+  c(2, 1) += 5e-5f;
+  EXPECT_TRUE(c == a);
+  c(2, 1) += 1e-3f;
+  EXPECT_FALSE(c == a);
+  c = a - a;
+  EXPECT_TRUE(c == S21MatrixF(4, 4));
+  c.SetRows(2);
+  EXPECT_EQ(c.GetRows(), 2);
+  EXPECT_THROW(a.MulMatrix(c), std::out_of_range);
+  EXPECT_THROW(a.SumMatrix(c), std::logic_error);
+  EXPECT_THROW(c.Determinant(), std::logic_error);
+  EXPECT_THROW(S21MatrixF(4, 4).InverseMatrix(), std::out_of_range);
+}
+
+TEST(BasicMatrix, test2_complex) {
+  using C = std::complex<double>;
+  S21MatrixCD a(2, 2), b(2, 2);
+  a(0, 0) = C(1, 1);
+  a(0, 1) = C(0, 2);
+  a(1, 0) = C(3, 0);
+  a(1, 1) = C(1, -1);
+  b(0, 0) = C(0, 1);
+  b(1, 1) = C(2, 0);
+  S21MatrixCD product = a * b;
+  EXPECT_EQ(product(0, 0), C(-1, 1));
+  EXPECT_EQ(product(0, 1), C(0, 4));
+  EXPECT_EQ(product(1, 0), C(0, 3));
+  EXPECT_EQ(product(1, 1), C(2, -2));
+  EXPECT_EQ(a.Determinant(), C(2, 0) - C(0, 6));
+  S21MatrixCD scaled = a * C(0, 1);
+  EXPECT_EQ(scaled(0, 0), C(-1, 1));
+  // det(diag(1 + i)) over five rows takes the LU path: (1 + i)^5.
+  S21MatrixCD d(5, 5), identity(5, 5);
+  for (int i = 0; i < 5; i++) {
+    d(i, i) = C(1, 1);
+    d(i, (i + 1) % 5) += C(0, 0.5);
+    identity(i, i) = 1.0;
+  }
+  EXPECT_TRUE(d * d.InverseMatrix() == identity);
+  S21MatrixCD cofactors = d.CalcComplements();
+  EXPECT_TRUE(cofactors.Transpose() * d == identity * d.Determinant());
+  S21MatrixCF f = S21MatrixCast<std::complex<float>>(d);
+  S21MatrixCF f_identity = S21MatrixCast<std::complex<float>>(identity);
+  EXPECT_TRUE(f * f.InverseMatrix() == f_identity);
+}
+
+TEST(BasicMatrix, test3_large_products_and_casts) {
+  // Sizes that are not multiples of any register tile, and large enough to
+  // cross the cache blocks and the thread-pool split.
+  S21Matrix a(150, 300), b(300, 130);
+  a.SetMatrixIncremented(-100.0);
+  b.SetMatrixIncremented(7.0);
+  a *= 1e-3;
+  b *= 1e-4;
+  S21Matrix expected = a * b;
+  S21MatrixF af = S21MatrixCast<float>(a), bf = S21MatrixCast<float>(b);
+  S21Matrix diff = S21MatrixCast<double>(af * bf) - expected;
+  double error = 0.0;
+  double scale = 0.0;
+  for (int i = 0; i < 150; i++) {
+    for (int j = 0; j < 130; j++) {
+      error = std::max(error, std::fabs(diff(i, j)));
+      scale = std::max(scale, std::fabs(expected(i, j)));
+    }
+  }
+  EXPECT_LT(error, 1e-5 * scale);
+  S21MatrixL al = S21MatrixCast<long double>(a);
+  S21MatrixL bl = S21MatrixCast<long double>(b);
+  EXPECT_TRUE(S21MatrixCast<double>(al * bl) == expected);
+  S21MatrixCD ac = S21MatrixCast<std::complex<double>>(a);
+  S21MatrixCD bc =
+      S21MatrixCast<std::complex<double>>(b) * std::complex<double>(0, 1);
+  S21MatrixCD pc = ac * bc;
+  EXPECT_NEAR(pc(17, 23).real(), 0.0, 1e-12);
+  EXPECT_NEAR(pc(17, 23).imag(), expected(17, 23), 1e-9);
+  S21MatrixL h(6, 6);
+  for (int i = 0; i < 6; i++) {
+    for (int j = 0; j < 6; j++) h(i, j) = 1.0L / (i + j + 1);
+  }
+  // det of the 6 x 6 Hilbert matrix is 1 / 186313420339200000.
+  EXPECT_NEAR(static_cast<double>(h.Determinant() * 186313420339200000.0L),
+              1.0, 1e-6);
+}
+
 int main(int argc, char *argv[]) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,140 @@
+#include "s21_thread_pool.h"
+
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+thread_local bool in_pool_task = false;
+
+int DefaultThreads() {
+  int threads = static_cast<int>(std::thread::hardware_concurrency());
+  const char* env = std::getenv("S21_NUM_THREADS");
+  if (env != nullptr && std::atoi(env) > 0) {
+    threads = std::atoi(env);
+  }
+  return threads > 0 ? threads : 1;
+}
+
+}  // namespace
+
+S21ThreadPool& S21ThreadPool::Instance() {
+  static S21ThreadPool pool;
+  return pool;
+}
+
+S21ThreadPool::S21ThreadPool()
+    : threads_(1),
+      stop_(false),
+      generation_(0),
+      busy_(0),
+      count_(0),
+      next_(0),
+      task_(nullptr) {
+  Start(DefaultThreads());
+}
+
+S21ThreadPool::~S21ThreadPool() { Stop(); }
+
+int S21ThreadPool::GetThreads() { return threads_.load(); }
+
+void S21ThreadPool::SetThreads(int threads) {
+  if (threads < 1) {
+    throw std::logic_error("The number of threads cannot be less than 1\n");
+  }
+  std::lock_guard<std::mutex> lock(submit_);
+  if (threads != static_cast<int>(workers_.size()) + 1) {
+    Stop();
+    Start(threads);
+  }
+}
+
+void S21ThreadPool::Start(int threads) {
+  stop_ = false;
+  threads_ = threads;
+  // Workers start out having seen the current generation; ParallelFor
+  // cannot bump it before Start returns, as the caller holds submit_.
+  for (int i = 1; i < threads; i++) {
+    workers_.emplace_back(&S21ThreadPool::WorkerLoop, this, generation_);
+  }
+}
+
+void S21ThreadPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+}
+
+void S21ThreadPool::ParallelFor(int count,
+                                const std::function<void(int)>& task) {
+  std::unique_lock<std::mutex> submit(submit_, std::try_to_lock);
+  if (in_pool_task || !submit.owns_lock() || workers_.empty() || count < 2) {
+    for (int i = 0; i < count; i++) {
+      task(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    next_ = 0;
+    busy_ = static_cast<int>(workers_.size());
+    error_ = nullptr;
+    generation_++;
+  }
+  wake_.notify_all();
+  RunTasks();
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this] { return busy_ == 0; });
+  task_ = nullptr;
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void S21ThreadPool::WorkerLoop(unsigned long seen) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+    if (stop_) break;
+    seen = generation_;
+    lock.unlock();
+    RunTasks();
+    lock.lock();
+    if (--busy_ == 0) {
+      done_.notify_one();
+    }
+  }
+}
+
+void S21ThreadPool::RunTasks() {
+  in_pool_task = true;
+  while (true) {
+    int index;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (next_ >= count_ || error_) break;
+      index = next_++;
+    }
+    try {
+      (*task_)(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) error_ = std::current_exception();
+    }
+  }
+  in_pool_task = false;
+}
+
+void S21SetNumThreads(int threads) {
+  S21ThreadPool::Instance().SetThreads(threads);
+}
+
+int S21GetNumThreads() { return S21ThreadPool::Instance().GetThreads(); }
@@ -0,0 +1,60 @@
+#ifndef SRC_S21_THREAD_POOL_H_
+#define SRC_S21_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent worker threads shared by every parallel kernel of the library.
+// The calling thread always takes part, so a pool of n threads owns n - 1
+// workers. The initial size is S21_NUM_THREADS from the environment or, if
+// unset, the number of hardware threads.
+class S21ThreadPool {
+ public:
+  static S21ThreadPool& Instance();
+
+  S21ThreadPool(const S21ThreadPool&) = delete;
+  S21ThreadPool& operator=(const S21ThreadPool&) = delete;
+  ~S21ThreadPool();
+
+  int GetThreads();
+  void SetThreads(int threads);
+
+  // Calls task(0) ... task(count - 1) spread over the pool and returns once
+  // all of them are done, rethrowing the first exception a task threw. Calls
+  // made from inside a task, or while another thread holds the pool, run
+  // serially on the caller.
+  void ParallelFor(int count, const std::function<void(int)>& task);
+
+ private:
+  S21ThreadPool();
+  void Start(int threads);
+  void Stop();
+  // Runs every batch after generation seen until the pool stops.
+  void WorkerLoop(unsigned long seen);
+  void RunTasks();
+
+  std::mutex submit_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::vector<std::thread> workers_;
+  std::atomic<int> threads_;
+  bool stop_;
+  unsigned long generation_;
+  int busy_;
+  int count_;
+  int next_;
+  const std::function<void(int)>* task_;
+  std::exception_ptr error_;
+};
+
+// Shorthands for S21ThreadPool::Instance().SetThreads / GetThreads.
+void S21SetNumThreads(int threads);
+int S21GetNumThreads();
+
+#endif  // SRC_S21_THREAD_POOL_H_
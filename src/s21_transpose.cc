@@ -0,0 +1,83 @@
+#include "s21_transpose.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "s21_simd.h"
+
+namespace {
+
+constexpr int kTile = kS21TransposeTile;
+
+// Blocks with both sides at or below kLeaf (32 x 32 doubles, 8 KiB per side)
+// are transposed tile by tile.
+constexpr int kLeaf = 32;
+
+void Leaf(const S21Kernels& kernels, int rows, int cols, const double* a,
+          int lda, double* b, int ldb) {
+  int full_rows = rows - rows % kTile;
+  int full_cols = cols - cols % kTile;
+  for (int i = 0; i < full_rows; i += kTile) {
+    for (int j = 0; j < full_cols; j += kTile) {
+      kernels.transpose(a + i * lda + j, lda, b + j * ldb + i, ldb);
+    }
+    for (int r = i; r < i + kTile; r++) {
+      for (int j = full_cols; j < cols; j++) b[j * ldb + r] = a[r * lda + j];
+    }
+  }
+  for (int i = full_rows; i < rows; i++) {
+    for (int j = 0; j < cols; j++) b[j * ldb + i] = a[i * lda + j];
+  }
+}
+
+// Splits at a multiple of the tile so only the outer edge has partial tiles.
+int Half(int size) { return std::max(kTile, size / 2 / kTile * kTile); }
+
+void Recurse(const S21Kernels& kernels, int rows, int cols, const double* a,
+             int lda, double* b, int ldb) {
+  if (rows <= kLeaf && cols <= kLeaf) {
+    Leaf(kernels, rows, cols, a, lda, b, ldb);
+  } else if (rows >= cols) {
+    int top = Half(rows);
+    Recurse(kernels, top, cols, a, lda, b, ldb);
+    Recurse(kernels, rows - top, cols, a + top * lda, lda, b + top, ldb);
+  } else {
+    int left = Half(cols);
+    Recurse(kernels, rows, left, a, lda, b, ldb);
+    Recurse(kernels, rows, cols - left, a + left, lda, b + left * ldb, ldb);
+  }
+}
+
+}  // namespace
+
+void S21Transpose(int rows, int cols, const double* a, int lda, double* b,
+                  int ldb) {
+  Recurse(S21GetKernels(), rows, cols, a, lda, b, ldb);
+}
+
+void S21TransposeInPlace(int n, double* a, int lda) {
+  const S21Kernels& kernels = S21GetKernels();
+  alignas(64) double tile[kTile * kTile];
+  int full = n - n % kTile;
+  for (int i = 0; i < full; i += kTile) {
+    double* diagonal = a + i * lda + i;
+    kernels.transpose(diagonal, lda, tile, kTile);
+    for (int r = 0; r < kTile; r++) {
+      std::copy(tile + r * kTile, tile + (r + 1) * kTile, diagonal + r * lda);
+    }
+    for (int j = i + kTile; j < full; j += kTile) {
+      double* upper = a + i * lda + j;
+      double* lower = a + j * lda + i;
+      kernels.transpose(upper, lda, tile, kTile);
+      kernels.transpose(lower, lda, upper, lda);
+      for (int r = 0; r < kTile; r++) {
+        std::copy(tile + r * kTile, tile + (r + 1) * kTile, lower + r * lda);
+      }
+    }
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = std::max(i + 1, full); j < n; j++) {
+      std::swap(a[i * lda + j], a[j * lda + i]);
+    }
+  }
+}
@@ -0,0 +1,16 @@
+#ifndef SRC_S21_TRANSPOSE_H_
+#define SRC_S21_TRANSPOSE_H_
+
+// b = a^T for the rows x cols row-major block a (leading dimension lda);
+// b is cols x rows with leading dimension ldb and must not overlap a. The
+// block is halved along its longer side until it fits in L1, so both a and
+// b are walked cache-obliviously, and the leaves go through the SIMD tile
+// kernel.
+void S21Transpose(int rows, int cols, const double* a, int lda, double* b,
+                  int ldb);
+
+// a = a^T for the n x n row-major block a, in place and without allocating:
+// mirrored tile pairs are swapped through a tile-sized stack buffer.
+void S21TransposeInPlace(int n, double* a, int lda);
+
+#endif  // SRC_S21_TRANSPOSE_H_